@@ -135,6 +135,9 @@ int frontpareto2::addIfHigherVal(bst* r, cst_t c, val_t v){
         if(r->cst==c)
         if(r->val < v){
             r->val = v;
+            #ifdef ATTACH_INFO_TO_PAIRS
+            lastAdded = r;                //the info of r is replaced, not that of the
+            #endif                        //last new leaf
             filter(r);
             return 1;
         }
@@ -171,7 +174,9 @@ void frontpareto2::freeMem(bst*r){
     delete r;
 }
 void frontpareto2::freeMem(){
-    freeMem(root);
+    if(root!=NULL)
+        freeMem(root);
+    root = NULL;                    //the front can be filled again
 }
 void frontpareto2::liste_print(bst* r, char* prefix, int left_child){
     if(r==NULL) 
@@ -275,7 +280,9 @@ void frontpareto2::freeMem(void(*newCallbackFreeAttached)(void*), bst*r){
     delete r;
 }
 void frontpareto2::freeMem(void(*newCallbackFreeAttached)(void*)){
-    freeMem(newCallbackFreeAttached, root);
+    if(root!=NULL)
+        freeMem(newCallbackFreeAttached, root);
+    root = NULL;
 }
 
 #endif
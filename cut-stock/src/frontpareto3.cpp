@@ -0,0 +1,149 @@
+/*-------+-------------------------------------------------------------------------+------------+
+         | See file LICENSE at the root of the git project for licence information |
+         +------------------------------------------------------------------------*/
+
+#include<cstring>
+#include<iostream>
+using namespace std;
+
+#include "frontpareto3.h"
+
+frontpareto3::~frontpareto3(){
+    delete[] pairs;
+}
+
+//the index of the first pair of cost higher than cst, nrPairs if there is none
+int frontpareto3::firstHigherCst(cst_t cst){
+    int lo = 0;
+    int hi = nrPairs;
+    while(lo<hi){
+        int mid = (lo+hi)/2;
+        if(pairs[mid].cst<=cst)
+            lo = mid+1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+void frontpareto3::grow(){
+    capacity = (capacity==0)?4:2*capacity;
+    fpair* bigger = new fpair[capacity];
+    if(nrPairs>0)
+        memcpy(bigger, pairs, nrPairs*sizeof(fpair));
+    delete[] pairs;
+    pairs = bigger;
+}
+
+int frontpareto3::addIfHigherVal(cst_t c, val_t v){
+    int k = firstHigherCst(c);                  //pairs[k-1].cst <= c < pairs[k].cst
+    if( (k>0) && (pairs[k-1].val>=v) )
+        return 0;
+    //the pairs from k on with a value not higher than v become dominated
+    int end = k;
+    while( (end<nrPairs) && (pairs[end].val<=v) )
+        end++;
+    int pos = k;
+    if( (k>0) && (pairs[k-1].cst==c) )          //same cost, higher value: it replaces
+        pos = k-1;                              //the pair before k
+    else if(end==k){                            //nothing dominated: make room at k
+        if(nrPairs==capacity)
+            grow();
+        memmove(pairs+k+1, pairs+k, (nrPairs-k)*sizeof(fpair));
+        nrPairs++;
+    }else
+        k++;                                    //the new pair overwrites pairs[k]
+    if(end>k){                                  //erase the dominated pairs [k,end)
+        memmove(pairs+k, pairs+end, (nrPairs-end)*sizeof(fpair));
+        nrPairs -= end-k;
+    }
+    pairs[pos].cst  = c;
+    pairs[pos].val  = v;
+    #ifdef ATTACH_INFO_TO_PAIRS
+    pairs[pos].info = NULL;
+    #endif
+    lastAdded = pos;
+    return 1;
+}
+
+//The array is kept for the next insertions, the destructor releases it
+void frontpareto3::freeMem(){
+    nrPairs  = 0;
+}
+
+void frontpareto3::printPairs(){
+    for(int i=0;i<nrPairs;i++)
+        cout<<pairs[i].cst<<"/"<<pairs[i].val<<endl;
+}
+
+int frontpareto3::first(cst_t& c, val_t& v){
+    if(nrPairs==0)
+        return 0; //Failure
+    iterator = 0;
+    c = pairs[iterator].cst;
+    v = pairs[iterator].val;
+    return 1;
+}
+int frontpareto3::next(cst_t& c, val_t& v){
+    if(++iterator>=nrPairs)
+        return 0;
+    c = pairs[iterator].cst;
+    v = pairs[iterator].val;
+    return 1;
+}
+int frontpareto3::first(val_t& v){
+    if(nrPairs==0)
+        return 0; //Failure
+    iterator = 0;
+    v = pairs[iterator].val;
+    return 1;
+}
+int frontpareto3::next(val_t& v){
+    if(++iterator>=nrPairs)
+        return 0;
+    v = pairs[iterator].val;
+    return 1;
+}
+int frontpareto3::last(cst_t& c, val_t& v){
+    if(nrPairs==0)
+        return 0; //Failure
+    iterator = nrPairs-1;
+    c = pairs[iterator].cst;
+    v = pairs[iterator].val;
+    return 1;
+}
+int frontpareto3::prev(cst_t& c, val_t& v){
+    if(--iterator<0)
+        return 0;
+    c = pairs[iterator].cst;
+    v = pairs[iterator].val;
+    return 1;
+}
+int frontpareto3::last(val_t& v){
+    if(nrPairs==0)
+        return 0; //Failure
+    iterator = nrPairs-1;
+    v = pairs[iterator].val;
+    return 1;
+}
+int frontpareto3::prev(val_t& v){
+    if(--iterator<0)
+        return 0;
+    v = pairs[iterator].val;
+    return 1;
+}
+
+#ifdef ATTACH_INFO_TO_PAIRS
+void frontpareto3::putInfoOnLastAdded(void* newinfo)
+{
+    pairs[lastAdded].info = newinfo;
+}
+void* frontpareto3::getInfoCurrElem(){
+    return pairs[iterator].info;
+}
+
+void frontpareto3::freeMem(void(*newCallbackFreeAttached)(void*)){
+    for(int i=0;i<nrPairs;i++)
+        newCallbackFreeAttached(pairs[i].info);
+    freeMem();
+}
+#endif
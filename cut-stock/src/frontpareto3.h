@@ -0,0 +1,84 @@
+/*  See accompanying .h for licence and documentation   */
+
+/*----------------------------------------------------------------------------------------------+
+|                                 PARETO FRONT DATA STRUCT                                      |
+|   This structure records a list of cost/profits (cst1,val1), (cst2,val2), (cst3,val3).. s.t.  |
+|      cst1<cst2<cst3.... and val1<val2<val3...                            (*)                  |
+|   Any new insertion returns 0 if the new pair can not verify this property, if it is          |
+|   dominated by the pair that that would stand before it. Otherwise, addIfHigherVal inserts the|
+|   new pair and returns 1 (any subsequent pairs that become dominated is deleted).             |
+|                                                                                               |
+|   Complexity: log(nr of entries) to find the position, plus the shift of the array           |
+|                                                                                               |
+|   -  This is a pareto front of non-dominated solutions for: min cost and max profit (value)   |
+|   -  You can think of this structure as a list of non-dominated states in a knapsack problem: |
+|            never increase the cost (weight) without increasing the profit (value)             |
+|   -  This is not a (priority) queue, because it needs some lookup operations                  |
+|   -  This is not a vague set, because it needs some previous/next operations                  |
++----------------------------------------------------------------------------------------------*/
+
+//The implementation from frontpareto3 keeps the pairs in a contiguous array sorted by
+//cost: binary search to insert, dominated pairs erased in place by shifting the array.
+//The fronts of the DPs of the sub-problems are short, so scanning or shifting a few
+//contiguous pairs is faster than chasing the nodes of frontpareto1 or frontpareto2
+
+
+#ifndef FRONTPARETO3_H
+#define FRONTPARETO3_H
+#include<cstdlib>
+
+//The use of this option may slow down things a bit, but it can be useful
+//if you need attach some additional information to each pareto front element,
+//e.g., a precedence relation to reconstruct an optimal solution in the end
+#define ATTACH_INFO_TO_PAIRS
+
+typedef int cst_t;       //What kind of cost type you have ?
+                          //If you can use ints (even by multiplying double values),
+                          //the proposed Pareto frontier is faster
+typedef double val_t   ;    //What kind of values you want to record ?
+
+typedef struct fpair_{
+    cst_t cst;
+    val_t val;
+    #ifdef ATTACH_INFO_TO_PAIRS
+    void* info;
+    #endif
+} fpair;
+
+class frontpareto3{
+   public:
+   //return 1 if the insertion is successful, 0 otherwise
+   int addIfHigherVal(cst_t cst, val_t v);
+   //The 8 functions below return 1 if the required pair was successful fetched
+   int first(cst_t &cst, val_t& v);
+   int next(cst_t  &cst, val_t& v);
+   int first(val_t& v);
+   int next(val_t& v);
+   int last(cst_t &cst, val_t& v);
+   int prev(cst_t  &cst, val_t& v);
+   int last(val_t& v);
+   int prev(val_t& v);
+   void printPairs();
+   //empties the front, keeping its array to fill it again, e.g., in the next DP call
+   void freeMem();
+   ~frontpareto3();
+
+
+#ifdef ATTACH_INFO_TO_PAIRS
+   void putInfoOnLastAdded(void *);
+   void* getInfoCurrElem();
+   //scan all pairs and apply the provided attached info eraser on each one
+   void freeMem(void(*newCallbackFreeAttached)(void*));
+#endif
+
+
+   private:
+   fpair* pairs    = NULL;  //allocated at the first insertion
+   int    nrPairs  = 0;
+   int    capacity = 0;
+   int    iterator;         //for first/next, as well as last/prev
+   int    lastAdded;
+   int    firstHigherCst(cst_t cst);
+   void   grow();
+};
+#endif
@@ -11,21 +11,28 @@
 #include <cstring>
 #include <climits>
 #include <cstdlib>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 
-int     currInst;                       //the current instance
-
-int     instancesInFile;                //the total number of instances
-int     instanceType;
-fstream currStream;                     //input stream
-
 //1 = .1bp files
 //2 = classical format with no extension
 #define BP1_FILE 1
 #define CLASSICAL 2
 #define TXT_FILE 3
 
-string instNameFromFile;   
+//A file mapped in memory, with the offset of each instance in the mapped bytes. Nothing
+//changes after openInstFile(), so several threads can read instances at once
+struct instFile_{
+    const char* data;                   //the mapped bytes, NULL for an empty file
+    size_t      size;
+    int         instanceType;
+    int         nrInst;
+    size_t*     offsets;                //of the first integer of each instance
+};
 
 //This function returns the file format of the cspFile: BP1_FILE or CLASSICAL
 int inputFileFormat(char*cspFile)
@@ -49,82 +56,194 @@ int inputFileFormat(char*cspFile)
     exit(1);
         
 }
-void readNextInst()
-{
-    int dump;
-    if(instanceType==BP1_FILE){
-        currStream >> ::C;
-        currStream >> dump;
-        currStream >> ::n;
-    }else{
-        currStream >> ::n;
-        currStream >> ::C;
-    }
-    clog<<"Reading instance nr "<<::currInst;
-    clog<<" with n="<<n<<" and tot. cap="<<C<<"and";
 
-    w = new int[::n];
-    b = new int[::n];
+/*----------------------  Tokenizer working on the mapped bytes  ---------------------*/
 
-    double sum=0;
-    for(int i=0;i<n;i++){ 
-        currStream >> w[i];
-        if(instanceType==TXT_FILE){
-            b[i] = 1;
-        }else{
-            currStream >> b[i];
-        }
-        sum+=((double)w[i]) * b[i];
+static inline bool isBlank(char c)
+{
+    return (c==' ')||(c=='\n')||(c=='\t')||(c=='\r');
+}
+//Advances pos to the next non-blank byte, returns 0 if there is none
+static inline int skipBlanks(const instFile* f, size_t& pos)
+{
+    while( (pos<f->size) && isBlank(f->data[pos]) )
+        pos++;
+    return pos<f->size;
+}
+//Skips the next token, returns 0 if there is none
+static inline int skipToken(const instFile* f, size_t& pos)
+{
+    if(!skipBlanks(f,pos))
+        return 0;
+    while( (pos<f->size) && !isBlank(f->data[pos]) )
+        pos++;
+    return 1;
+}
+//Reads the next integer into val, returns 0 if there is no (integer) token left
+static inline int nextInt(const instFile* f, size_t& pos, int& val)
+{
+    if(!skipBlanks(f,pos))
+        return 0;
+    int sign = 1;
+    if(f->data[pos]=='-'){
+        sign = -1;
+        pos++;
     }
-    clog<<"sum wi*bi="<<sum<<endl;
-    instNameFromFile = "";           //signals the fact that a new instance can be read   
+    if( (pos>=f->size) || (f->data[pos]<'0') || (f->data[pos]>'9') )
+        return 0;
+    long v = 0;
+    while( (pos<f->size) && (f->data[pos]>='0') && (f->data[pos]<='9') ){
+        v = v*10 + (f->data[pos]-'0');
+        pos++;
+    }
+    val = (int)(sign*v);
+    return 1;
+}
+//Reads the header of the instance at pos: the capacity C and the number of items n
+static inline int nextHeader(const instFile* f, size_t& pos, int& C, int& n)
+{
+    int dump;
+    if(f->instanceType==BP1_FILE)
+        return nextInt(f,pos,C) && nextInt(f,pos,dump) && nextInt(f,pos,n);
+    return nextInt(f,pos,n) && nextInt(f,pos,C);
 }
 
+/*----------------------  Mapping and indexing an instance file  ---------------------*/
 
-//returns 0 when there are no more instances
-//the instance name is stored in instNameFromFile
-int readInstNameFromFile()
+//The instance at pos: header, then n weights (TXT_FILE) or n pairs weight-demand.
+//Returns 0 if the file ends before it does
+static int skipInst(const instFile* f, size_t& pos)
 {
-    while(instNameFromFile.size()==0&&currStream.good()){
-        getline(currStream,instNameFromFile);
-    } 
-    return currStream.good();
+    int C, n;
+    if( (!nextHeader(f,pos,C,n)) || (n<0) )
+        return 0;
+    long tokens = (f->instanceType==TXT_FILE)?n:2*(long)n;
+    for(long i=0;i<tokens;i++)
+        if(!skipToken(f,pos))
+            return 0;
+    return 1;
 }
-int moreInst()
+
+//Scans the file once and records where each instance starts
+static void indexInstFile(instFile* f)
 {
-    if( (instanceType==BP1_FILE) || (instanceType==TXT_FILE) )
-        return ::currInst<=instancesInFile;
-    else{
-        return readInstNameFromFile();
+    size_t pos         = 0;
+    int    declaredNr  = -1;            //CLASSICAL: unknown, the scan stops at the end
+    int    capacity    = 16;            //of f->offsets, doubled when full
+    if( (f->instanceType==BP1_FILE) || (f->instanceType==TXT_FILE) ){
+        if(!nextInt(f,pos,declaredNr))
+            declaredNr = 0;
+        capacity = max(declaredNr,1);
+    }
+    f->offsets = new size_t[capacity];
+    f->nrInst  = 0;
+    while( (declaredNr<0) || (f->nrInst<declaredNr) ){
+        if(!skipBlanks(f,pos))
+            break;
+        if(f->instanceType==CLASSICAL){ //skip the name line, e.g., 'BPP_U09993_10007'
+            while( (pos<f->size) && (f->data[pos]!='\n') )
+                pos++;
+        }
+        size_t start = pos;
+        if(!skipInst(f,pos))            //truncated file: drop the incomplete instance
+            break;
+        if(f->nrInst==capacity){
+            size_t* bigger = new size_t[2*capacity];
+            memcpy(bigger,f->offsets,capacity*sizeof(size_t));
+            delete[] f->offsets;
+            f->offsets = bigger;
+            capacity  *= 2;
+        }
+        f->offsets[f->nrInst++] = start;
     }
 }
 
+instFile* openInstFile(char* filename)
+{
+    instFile* f     = new instFile;
+    f->instanceType = inputFileFormat(filename);
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if( (fd<0) || (fstat(fd,&st)<0) ){
+        cerr<<"Can not open instance file '"<<filename<<"'\n";
+        exit(EXIT_FAILURE);
+    }
+    f->size = st.st_size;
+    f->data = NULL;
+    if(f->size>0){
+        void* mapped = mmap(NULL, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapped==MAP_FAILED){
+            cerr<<"Can not map instance file '"<<filename<<"' in memory\n";
+            exit(EXIT_FAILURE);
+        }
+        f->data = (const char*)mapped;
+    }
+    close(fd);                          //the mapping stays valid
+    indexInstFile(f);
+    return f;
+}
+
+int nrInstInFile(const instFile* f)
+{
+    return f->nrInst;
+}
 
-void readInstNrFromFile(int insNrRequest, char* filename)
+void readInstFromFile(const instFile* f, int insNrRequest, cspInstance& inst)
 {
-    ::currInst = 0;                     //first instance to be loaded 
-    currStream.open(filename, fstream::in);  
-    instanceType = inputFileFormat(filename);
-    if( (instanceType==BP1_FILE) || (instanceType==TXT_FILE) )
-        currStream >> instancesInFile;  //number of instances
-    else{
-        instancesInFile = -1;           //unknown number of instances, but the read stops when
-//        readInstNameFromFile();         //there are no other instances names in the file
+    if( (insNrRequest<0) || (insNrRequest>=f->nrInst) ){
+        cerr<<"Last read instance nr="<<f->nrInst-1<< "while you asked inst nr"
+            <<insNrRequest<<endl;
+        exit(EXIT_FAILURE);
     }
+    size_t pos = f->offsets[insNrRequest];
+    int C  = 0;
+    inst.n = 0;
+    if(!nextHeader(f,pos,C,inst.n)){
+        cerr<<"Instance nr "<<insNrRequest<<": the capacity or the number of items"
+            <<" is not an integer\n";
+        exit(EXIT_FAILURE);
+    }
+    inst.C = C;
+    clog<<"Reading instance nr "<<insNrRequest;
+    clog<<" with n="<<inst.n<<" and tot. cap="<<inst.C<<"and";
+
+    inst.w = new int[inst.n];
+    inst.b = new int[inst.n];
 
-    while ( moreInst() && (::currInst<=insNrRequest) ){
-        readNextInst();
-        ::currInst++;
-        if(::currInst<insNrRequest){
-            delete[] ::w;
-            delete[] ::b;
+    double sum=0;
+    for(int i=0;i<inst.n;i++){ 
+        if(!nextInt(f,pos,inst.w[i])){
+            cerr<<"Instance nr "<<insNrRequest<<": the weight of item "<<i
+                <<" is not an integer\n";
+            exit(EXIT_FAILURE);
         }
-    }     
-    if(::currInst-1<insNrRequest){
-        cerr<<"Last read instance nr="<<::currInst-1<< "while you asked inst nr"<<insNrRequest<<endl;
-        exit(EXIT_FAILURE);
+        if(f->instanceType==TXT_FILE){
+            inst.b[i] = 1;
+        }else if(!nextInt(f,pos,inst.b[i])){
+            cerr<<"Instance nr "<<insNrRequest<<": the demand of item "<<i
+                <<" is not an integer\n";
+            exit(EXIT_FAILURE);
+        }
+        sum+=((double)inst.w[i]) * inst.b[i];
     }
+    clog<<"sum wi*bi="<<sum<<endl;
 }
+
+void closeInstFile(instFile* f)
+{
+    if(f->data!=NULL)
+        munmap((void*)f->data, f->size);
+    delete[] f->offsets;
+    delete f;
+}
+
+void readInstNrFromFile(int insNrRequest, char* filename, cspInstance& inst)
+{
+    instFile* f = openInstFile(filename);
+    readInstFromFile(f,insNrRequest,inst);
+    closeInstFile(f);
+}
+
 //Returns an integer parameter from the config file, e.g., the value of kMax
 //Default return value: INT_MAX (when requestedParam is not found)
 int getParamFromConfigFile(char* requestedParam)
@@ -7,14 +7,23 @@
 #ifndef INOUT_H_INCLUDED
 #define INOUT_H_INCLUDED
 
-extern double  C;                    //capacity
-extern int     n;                    //the number of dual variables
-extern int*    b;                    //demands
-extern int*    w;                    //weights
-extern int     currInst;             //instance nr (zero indexed) to solve
+#include "subprob.h"                  //for cspInstance
 
-//Returns the instance number zeroIndexedNumber from file. Exits if error.
-void readInstNrFromFile(int zeroIndexedNumber, char* file);
+//An instance file mapped in memory and indexed: the offset of each instance is recorded
+//by a single scan, so that any instance can then be parsed directly from the mapped bytes
+typedef struct instFile_ instFile;
+
+//Maps and indexes file. Exits if error. The instFile does not change after, several
+//threads can read instances from it at once
+instFile* openInstFile(char* file);
+int  nrInstInFile(const instFile* f);
+//Parses the instance number zeroIndexedNumber into inst.C, n, b and w. Exits if error
+void readInstFromFile(const instFile* f, int zeroIndexedNumber, cspInstance& inst);
+void closeInstFile(instFile* f);
+
+//Reads the instance number zeroIndexedNumber from file into inst.C, n, b and w. Exits if
+//error. It keeps no state, several threads can read at once
+void readInstNrFromFile(int zeroIndexedNumber, char* file, cspInstance& inst);
 
 //Returns an integer parameter from the config file, e.g., the value of kMax
 //Default return value: INT_MAX (when requestedParam is not found)
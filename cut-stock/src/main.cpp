@@ -14,71 +14,103 @@
 #include<cstring>
 #include<climits>
 #include<cmath>
+#include<fstream>
+#include<thread>
+#include<atomic>
+#include<vector>
 
 using namespace std;
 #define EPSILON 1.0e-6
 
-/*----------------------   Project-wide Global Variables     ---------------------*/
-
-double    C;                 //base capacity
-double extC;                 //extended capacity (eg, for elastic vers, or multi-size bp)
-int       n;                 //the number of dual variables
-int*      b;                 //demands
-int*      w;                 //weights
-
 /*----------------------   Global Variables Used in Main     ---------------------*/
 
 int stdMethd         = 0;
 int rndmizedRunSeed  = 0; 
-int iter             = 0;
-double bstLowerBound = 0;
-int iterLowGap       = -1;   //iteration when ub<=bstLowerBound*1.2
-double tmLowGap      = -1;   //tm for above
+int warmStart        = 0;            //re-solve with the dual simplex from the last basis
+int pipelined        = 0;            //separate the previous primals during each re-solve
+char* statsFile      = NULL;         //per-iteration statistics, JSON lines if it ends in .jsonl
+int batchThreads     = -1;           //>=0: solve all instances of the file, 0=one per CPU
+int dpThreads        = 1;            //threads of the large DP passes of the intersection
+long dpLayerCells    = 0;            //>0: the DP of -std reuses the layers of its last call
+const costModel* costMdl = NULL;     //the cost function f, ml1 of initSubprobs by default
+int heurPeriod       = 0;            //>0: pricing heuristics before the DP of -std
+
+/*----------------------   State of the Solve of an Instance  ---------------------*/
+
+//The separator finds it in ctx.userData. The options above are only read once parsed,
+//so that several instances (each with its cspRun) can be solved in parallel threads
+typedef struct cspRun_{
+    cspInstance inst;
+    int    iter;
+    double bstLowerBound;
+    int    iterLowGap;               //iteration when ub<=bstLowerBound*1.2
+    double tmLowGap;                 //tm for above
+    int    lstIter;                  //iter when gap was closed
+    double lstTm;                    //time when gap was closed
+    double startCpuTime;
+    double (*cpuTime)();             //getCPUTime, or getThreadCPUTime in batch mode
+    ostream* out;                    //cout, or the buffer of the instance in batch mode
+} cspRun;
+
+void initRun(cspRun& run)
+{
+    initSubprobs(run.inst);
+    run.inst.dpThreads = dpThreads;
+    run.inst.dpLayerCells = dpLayerCells;
+    if(costMdl!=NULL)
+        run.inst.cost  = costMdl;
+    run.inst.heurPeriod = heurPeriod;
+    run.iter          = 0;
+    run.bstLowerBound = 0;
+    run.iterLowGap    = -1;
+    run.tmLowGap      = -1;
+    run.lstIter       = 0;
+    run.lstTm         = 0;
+    run.cpuTime       = getCPUTime;
+    run.startCpuTime  = run.cpuTime();
+    run.out           = &cout;
+}
 
-void checkLowGap(double lb, double ub, int iter, double tm){
-    if(iterLowGap>=0)       //low gap already achieved
+void checkLowGap(cspRun& run, double lb, double ub, int iter, double tm){
+    if(run.iterLowGap>=0)       //low gap already achieved
         return;
     if(ub<=lb*1.2){
-        iterLowGap = iter;
-        tmLowGap   = tm;
-        cout<<"REACHED LOW GAP iter,tm="<<iter<<","<<tm<<"\n";
+        run.iterLowGap = iter;
+        run.tmLowGap   = tm;
+        *run.out<<"REACHED LOW GAP iter,tm="<<iter<<","<<tm<<"\n";
     }
 }
-int equalBounds()
+//The optimum is a multiple of 1/fact, e.g., of 0.2 for ML-CSP
+int equalBounds(double bstLowerBound, double upperBound, double fact)
 {
-#ifdef EQUAL_BOUNDS
-    return EQUAL_BOUNDS(bstLowerBound,upperBound);
-#else
-    return (ceil(bstLowerBound)==ceil(upperBound)) ;
-#endif
+    return (ceil(fact*bstLowerBound)==ceil(fact*upperBound)) ;
 }
 
 //We return the violation rHand-neVars^T x that is negative in case of real violation
-double separator (const int nrVars, double*x, double * newCut, double&rHand)
+double separator (const int nrVars, double*x, double * newCut, double&rHand,
+                  cutPlanesCtx&ctx)
 {
-    static int    lstIter       = 0;               //iter when gap was closed
-    static double lstTm         = 0;               //time when gap was closed
-    static double startCpuTime  = getCPUTime();
-    assert(::n==nrVars);
+    cspRun& run = *(cspRun*)ctx.userData;
+    assert(run.inst.n==nrVars);
 
     bool separated;
     if(stdMethd)
-        separated = sepClassicalCalcBounds(x,newCut,rHand);
+        separated = sepClassicalCalcBounds(run.inst,x,newCut,rHand,ctx);
     else
-        separated = sepByIntersectCalcBounds(x,newCut,rHand,iter);
+        separated = sepByIntersectCalcBounds(run.inst,x,newCut,rHand,run.iter,ctx);
 
-    bstLowerBound    = max(lowerBound,bstLowerBound);
-    double tmElapsed = getCPUTime()-startCpuTime;
-    clog<<"            LB="<<lowerBound<<" BST LB="<<bstLowerBound<<
-          " it="<<::iter<<"\n              UB="<<::upperBound<<
+    run.bstLowerBound = max(ctx.lowerBound,run.bstLowerBound);
+    double tmElapsed  = run.cpuTime()-run.startCpuTime;
+    clog<<"            LB="<<ctx.lowerBound<<" BST LB="<<run.bstLowerBound<<
+          " it="<<run.iter<<"\n              UB="<<ctx.upperBound<<
           " Tm="<<tmElapsed<<endl;
-    //cout<<"("<<::iter<<","<<lowerBound<<")\n";//good for curve drawing with pgfplots
-    checkLowGap(bstLowerBound,::upperBound,::iter,tmElapsed);
+    //cout<<"("<<run.iter<<","<<ctx.lowerBound<<")\n";//good for curve drawing with pgfplots
+    checkLowGap(run,run.bstLowerBound,ctx.upperBound,run.iter,tmElapsed);
 
 #ifndef NDEBUG
     double violation = rHand;
     clog<<"Adding ";
-    for(int i=0; i<(::n); i++) {
+    for(int i=0; i<nrVars; i++) {
         violation -=newCut[i]*x[i];
         if(newCut[i]>EPSILON)
             clog<<"x["<<i<<"]*"<<newCut[i]<<"+";
@@ -91,17 +123,18 @@ double separator (const int nrVars, double*x, double * newCut, double&rHand)
         assert(violation>= -EPSILON);
 #endif
 
-    if( (lstIter==0)&&(equalBounds())) {
-        lstIter = ::iter;
-        lstTm = getCPUTime()-startCpuTime;
-        clog<<"------------>Tail cut iter="<<lstIter<<" tail cut time="<<lstTm<<endl;
+    if( (run.lstIter==0)&&(equalBounds(run.bstLowerBound,ctx.upperBound,
+                                           run.inst.cost->boundsFact))) {
+        run.lstIter = run.iter;
+        run.lstTm   = run.cpuTime()-run.startCpuTime;
+        clog<<"------------>Tail cut iter="<<run.lstIter<<" tail cut time="<<run.lstTm<<endl;
         return INT_MAX;
     }
 
     if(!separated)
-        clog<<"------------>curr opt sol is globally opt at iter="<<::iter<<endl;
+        clog<<"------------>curr opt sol is globally opt at iter="<<run.iter<<endl;
 
-    ::iter++;
+    run.iter++;
     if(separated)
         return -1;
     else
@@ -109,19 +142,20 @@ double separator (const int nrVars, double*x, double * newCut, double&rHand)
 }
 //The linux kernel style allows function-like macros in a do-while that defines a block
 //It also states: "macros resembling functions may be named in lower case"
-//Macro below generates a value for ::lowerBound 
-#define separateOnce(x,newCut,rHand,cutPlanes)                                      \
+//Macro below generates a value for ctx.lowerBound 
+#define separateOnce(run,x,newCut,rHand,cutPlanes)                                  \
   do{                                                                               \
+    cutPlanesCtx& ctx = cutPlanes.getCtx();                                         \
     if(stdMethd){                                                                   \
-        upperBound = 0;                                                             \
-        for(int i=0;i<n;i++)                                                        \
-            upperBound+=x[i];                                                       \
-        sepClassicalCalcBounds(x,newCut,rHand);       /* this uses upperBound */    \
+        ctx.upperBound = 0;                                                         \
+        for(int i=0;i<run.inst.n;i++)                                               \
+            ctx.upperBound+=x[i];                                                   \
+        sepClassicalCalcBounds(run.inst,x,newCut,rHand,ctx);/* uses upperBound */   \
     }else                                                                           \
-        sepByIntersectCalcBounds(x,newCut,rHand,iter);                              \
+        sepByIntersectCalcBounds(run.inst,x,newCut,rHand,run.iter,ctx);             \
     cutPlanes.modelAddCut(newCut,rHand);                                            \
     clog<<endl<<"new init cut ";                                                    \
-    for(int ii=0;ii<n;ii++)                                                         \
+    for(int ii=0;ii<run.inst.n;ii++)                                                \
         if(newCut[ii]!=0)                                                           \
             clog<<newCut[ii]<<"/"<<ii<<" ";                                         \
     clog<<endl<<"***************END Initial sub-problem*******************"<<endl;  \
@@ -145,102 +179,92 @@ string getTmStr(double tm){
         sBuilder <<left<<setw(6)<<"<1e-3";
     return sBuilder.str();
 }
-int main(int argc, char**argv)
-{
-#ifdef NDEBUG
-    cout<<"I'll be silent, ignoring clog in release more (NDEBUG)."<<endl;
-    clog.setstate(ios_base::failbit);                                       //disable clog
-#endif
-    if(argc==1) {
-        cerr<<"Usage: ./main instance zeroIndexedInstNrInFile [-si[lent]] "
-              "[-std: use standard Col Gen] [-rnd : randomized run]\n"
-              "       projective cutting planes used by default, use -std to change to the standard col gen\n"
-              "       to change the multiple-length variant, modify lines 40-60 "
-                      " in subprob.h, you can also test variable sized bin packing\n";
-        return EXIT_FAILURE;
-    }
-    while(argv[argc-1][0]=='-') {
-        int optionsFnd = 0;
-        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-si",3))) {
-            cout<<"I'll be silent, ignoring clog."<<endl;
-            clog.setstate(ios_base::failbit);                               //disable clog
-            argc--;
-            optionsFnd++;
-        }
-        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-std",4))) {
-            cout<<"I'll use old classical method."<<endl;
-            stdMethd=1;
-            argc--;
-            optionsFnd++;
-        }
-        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-rnd",4))) {
-            if(strlen(argv[argc-1])==4)
-                rndmizedRunSeed = time(NULL);
-            else
-                rndmizedRunSeed = atoi(argv[argc-1]+4);
-            cout<<"I'll randomize Simplex with seed "<<rndmizedRunSeed<<endl;
-            argc--;
-            optionsFnd++;
-        }
-        if(optionsFnd==0) {
-            cerr<<"There is an argument starting with '-' that I can not understand\n";
-            cerr<<"Accepted arguments:[-si[lent]] [-cl[assicalOldMeth]]\n";
-            exit(EXIT_FAILURE);
-        }
-    }
-    if(argc>3) {
-        cerr<<"You gave me 3 arguments with no '-'. I don't understand the third.\n";
-        exit(EXIT_FAILURE);
-    }
-    if(argc==2) {
-        cout<<"I take the first instance in "<<argv[1]<<endl;
-        readInstNrFromFile(0,argv[1]);
-    } else
-        readInstNrFromFile(atoi(argv[2]),argv[1]);
-    //clog<<"C="<<C<<endl ; for(int i=0;i<n;i++) clog<<w[i]<<" "<<b[i]<<endl;
+//Writes the statistics of each iteration of cutPlanes to statsName (see -stats)
+#define openStatsFile(statsOut,statsName,cutPlanes)                                 \
+  do{                                                                               \
+    statsOut.open(statsName);                                                       \
+    if(!statsOut.good()){                                                           \
+        cerr<<"Can not open statistics file '"<<statsName<<"'\n";                   \
+        exit(EXIT_FAILURE);                                                         \
+    }                                                                               \
+    int len = strlen(statsName);                                                    \
+    if((len>=6)&&(!strcmp(statsName+len-6,".jsonl")))                               \
+        cutPlanes.writeIterStats(statsOut, ITER_STATS_JSONL);                       \
+    else                                                                            \
+        cutPlanes.writeIterStats(statsOut, ITER_STATS_CSV);                         \
+  }while(0);
 
-    extC = C*EXT_MAX;
+//Solves the instance already loaded in run.inst (instance instNr of file). The results go
+//to *run.out, except the row of tabular latex data that goes to tab. statsName can be
+//NULL (no statistics file)
+void solveInstance(cspRun& run, char* file, int instNr, ostream& tab,
+                   const char* statsName)
+{
+    ostream& out  = *run.out;
+    run.inst.extC = run.inst.C*run.inst.cost->extMax;
+    const int n = run.inst.n;
+    int*      b = run.inst.b;
+    int*      w = run.inst.w;
 
     CuttingPlanesEngine cutPlanes(n,separator);
-    cutPlanes.setVarBounds(0,EXT_MAX);
+    cutPlanes.setSeparatorData(&run);
+    cutPlanes.setVarBounds(0,run.inst.cost->extMax);
     if(rndmizedRunSeed>0)
         cutPlanes.setObjCoefsMaxRandomizedSolving(b,rndmizedRunSeed);
     else
         cutPlanes.setObjCoefsMaximize(b);
+    if(warmStart)
+        cutPlanes.activateWarmStart();
+    if(pipelined)
+        cutPlanes.activatePipelining();
+    ofstream statsOut;
+    if(statsName!=NULL)
+        openStatsFile(statsOut,statsName,cutPlanes);
 
     int itersUsed;
     double CPUtimeUsed;                     //including time of cplex threads
     time_t start = time(NULL);
 
     /*--------------          Start add initial constraints        --------------*/
-    static double*x = new double[n];
-    static double * newCut = new double[n];
+    double*x      = new double[n];
+    double*newCut = new double[n];
     double rHand;
 
     for(int i=0; i<n; i++)                
-        x[i] = w[i]/extC;                  
-    separateOnce(x,newCut,rHand,cutPlanes);
-    if( !((stdMethd) && (MIN_PATT_COST!=1)) )        //bound not correct for std method
-        bstLowerBound=max(lowerBound,bstLowerBound); //in mult-len CSP 
+        x[i] = w[i]/run.inst.extC;                  
+    separateOnce(run,x,newCut,rHand,cutPlanes);
+    if( !((stdMethd) && (run.inst.cost->minPattCost!=1)) )//bound not correct for std
+        run.bstLowerBound=max(cutPlanes.getLowerBound(),run.bstLowerBound);//in ML-CSP
 
     for(int i=0; i<n; i++)
         x[i] = b[i];
-    separateOnce(x,newCut,rHand,cutPlanes);
-    //if( !((stdMethd) && (MIN_PATT_COST!=1)) )      //bound ok for std method in
-    bstLowerBound=max(lowerBound,bstLowerBound);     //mult-len CSP, as b is infeasible
+    separateOnce(run,x,newCut,rHand,cutPlanes);
+    //if( !((stdMethd) && (run.inst.cost->minPattCost!=1)) ) //bound ok for std meth in
+    run.bstLowerBound=max(cutPlanes.getLowerBound(),run.bstLowerBound);//ML-CSP, b infeas.
 
-    clog<<"                                      -> START BEST LB="<<bstLowerBound<<endl;
+    clog<<"                                      -> START BEST LB="<<run.bstLowerBound<<endl;
+    delete[] x;
+    delete[] newCut;
 
     /*--------------           End  add initial constraints        --------------*/
 
     //Launch main Cutting Planes (dual Col Gen) Engine
+    run.startCpuTime = run.cpuTime();
     if(cutPlanes.runCutPlanes(itersUsed, CPUtimeUsed)==EXIT_FAILURE)
-        cerr<<"\n\n ATTENTION: NOT enough time or iters to fully optimize!";
+        cerr<<"\n\n ATTENTION: NOT enough time or iters to fully optimize instance "
+            <<instNr<<"!";
+    if(run.cpuTime!=getCPUTime)             //the engine measures the whole process
+        CPUtimeUsed = run.cpuTime()-run.startCpuTime;
 
     /*--------------               Printing final results         ---------------*/
     double finalObj = cutPlanes.getObjVal();
-    cout<<"CPU Time:"<<CPUtimeUsed<<"   Real time:"<<time(NULL)-start<<endl;
-    cout<<"\nFinal obj val="<<finalObj<<" obtained after "<<itersUsed<<" iterations."<<endl;
+    out<<"CPU Time:"<<CPUtimeUsed<<"   Real time:"<<time(NULL)-start<<endl;
+    out<<"\nFinal obj val="<<finalObj<<" obtained after "<<itersUsed<<" iterations."<<endl;
+    out<<"Simplex iterations:"<<cutPlanes.getNrSimplexIters()<<" ("
+       <<(double)cutPlanes.getNrSimplexIters()/max(itersUsed,1)<<" per iteration), LP solve time:"
+        <<cutPlanes.getTmOnlySolve()<<endl;
+    if(pipelined)
+        out<<"Cuts separated on stale primals:"<<cutPlanes.getNrStaleCuts()<<endl;
 
     //Print final solution to clog
     double*xx = new double[n];
@@ -249,12 +273,13 @@ int main(int argc, char**argv)
         if(xx[i]>EPSILON)
             clog<<"x["<<i<<"]="<<xx[i]<<"; ";
     clog<<endl;
+    delete[] xx;
     
     /*--------------               Printing latex results         ---------------*/
-    if(iterLowGap==itersUsed)
-        CPUtimeUsed = tmLowGap;      //do not count time spent on printing above info
+    if(run.iterLowGap==itersUsed)
+        CPUtimeUsed = run.tmLowGap;  //do not count time spent on printing above info
     char* inst = new char[100];      //instance name
-    strcpy(inst,argv[1]);
+    strcpy(inst,file);
     inst = rindex(inst,'/')+1;       //remove folders, keep filename
     char instName[300];
     if(strchr(inst,'.')!=NULL){
@@ -262,19 +287,254 @@ int main(int argc, char**argv)
             inst[strlen(inst)-1]='\0';
         inst[strlen(inst)-1]='\0'; //remove dot
     }
-    sprintf(instName,"\\texttt{%s-%d}&%g&",inst,1+((argc==2)?0:atoi(argv[2])),finalObj);
+    sprintf(instName,"\\texttt{%s-%d}&%g&",inst,1+instNr,finalObj);
 
-    cout<<"Tabular latex data below:\n";
+    if(&tab==&out)                   //in batch mode, all rows come together at the end
+        out<<"Tabular latex data below:\n";
     if(stdMethd==0)
-        cout<<setw(40)<<instName;
+        tab<<setw(40)<<instName;
     else
-        cout<<setw(40)<<" ";
-    cout<<setw(5)<<iterLowGap           <<"&"<<
-          setw(7)<<getTmStr(tmLowGap)   <<"&"<<
-          setw(5)<<itersUsed            <<"&"<<
-          setw(7)<<getTmStr(CPUtimeUsed);
+        tab<<setw(40)<<" ";
+    tab<<setw(5)<<run.iterLowGap           <<"&"<<
+         setw(7)<<getTmStr(run.tmLowGap)   <<"&"<<
+         setw(5)<<itersUsed                <<"&"<<
+         setw(7)<<getTmStr(CPUtimeUsed);
     if(stdMethd==0)
-        cout<<"&"<<endl;
+        tab<<"&"<<endl;
+    else
+        tab<<"\\\\%"<<endl;
+}
+
+//The statistics file of instance instNr in batch mode: statsFile with "-instNr" inserted
+//before the extension, e.g., stats.csv -> stats-7.csv
+string statsFileOfInst(const char* statsFile, int instNr)
+{
+    string name = statsFile;
+    size_t dot  = name.rfind('.');
+    size_t dir  = name.rfind('/');
+    if( (dot==string::npos) || ((dir!=string::npos)&&(dot<dir)) )
+        dot = name.size();
+    return name.substr(0,dot) + "-" + toString(instNr) + name.substr(dot);
+}
+
+//Indexes file once and solves all its instances in a pool of nrThreads worker threads
+//(0 = one per CPU), each thread parsing its instances from the mapped file. Each instance
+//writes into its own buffer; the buffers and the rows of tabular latex data are printed
+//in the order of the instances once all are solved
+void solveBatch(char* file, int nrThreads)
+{
+    instFile* f      = openInstFile(file);
+    const int nrInst = nrInstInFile(f);
+    if(nrInst==0){
+        cerr<<"No instance could be read from "<<file<<endl;
+        exit(EXIT_FAILURE);
+    }
+    if(nrThreads==0)
+        nrThreads = thread::hardware_concurrency();
+    nrThreads = max(1,min(nrThreads,nrInst));
+    cout<<"I'll solve the "<<nrInst<<" instances in "<<file<<" with "<<nrThreads
+        <<" threads."<<endl;
+
+    ostringstream* outs = new ostringstream[nrInst];
+    ostringstream* tabs = new ostringstream[nrInst];
+    atomic<int> nextInst(0);
+    double startWallTm  = getWallTime();
+
+    vector<thread> pool;
+    for(int t=0;t<nrThreads;t++)
+        pool.push_back(thread([&]{
+            int i;
+            while( (i=nextInst++) < nrInst ){
+                cspRun run;
+                initRun(run);
+                readInstFromFile(f,i,run.inst);
+                run.cpuTime      = getThreadCPUTime;   //the CPU time of this instance
+                run.startCpuTime = run.cpuTime();
+                run.out          = &outs[i];
+                outs[i]<<"------------------ Instance "<<i<<" ------------------"<<endl;
+                if(statsFile!=NULL){
+                    string statsName = statsFileOfInst(statsFile,i);
+                    solveInstance(run,file,i,tabs[i],statsName.c_str());
+                }else
+                    solveInstance(run,file,i,tabs[i],NULL);
+                freeSubprobs(run.inst);
+                delete[] run.inst.w;
+                delete[] run.inst.b;
+            }
+        }));
+    for(int t=0;t<nrThreads;t++)
+        pool[t].join();
+
+    for(int i=0;i<nrInst;i++)
+        cout<<outs[i].str();
+    cout<<"Tabular latex data below:\n";
+    for(int i=0;i<nrInst;i++)
+        cout<<tabs[i].str();
+    cout<<"Solved "<<nrInst<<" instances with "<<nrThreads<<" threads in real time:"
+        <<getWallTime()-startWallTm<<endl;
+    delete[] outs;
+    delete[] tabs;
+    closeInstFile(f);
+}
+
+int main(int argc, char**argv)
+{
+#ifdef NDEBUG
+    cout<<"I'll be silent, ignoring clog in release more (NDEBUG)."<<endl;
+    clog.setstate(ios_base::failbit);                                       //disable clog
+#endif
+    if(argc==1) {
+        cerr<<"Usage: ./main instance zeroIndexedInstNrInFile [-si[lent]] "
+              "[-std: use standard Col Gen] [-rnd : randomized run] [-ws: warm-started re-solves]\n"
+              "       [-pipe: separate the previous primals during each re-solve]\n"
+              "       [-statsFILE: write the statistics of each iteration to FILE, as CSV\n"
+              "                    or as JSON lines if FILE ends in .jsonl]\n"
+              "       [-batch[THREADS]: solve all instances of the file (no instance number)\n"
+              "                    with THREADS worker threads, one per CPU by default]\n"
+              "       [-dpthreads[THREADS]: share the large DP passes of the intersection\n"
+              "                    sub-problem between THREADS threads, one per CPU by default]\n"
+              "       [-dplayers[CELLS]: with -std, the DP keeps the weights reached by its\n"
+              "                    articles (at most CELLS, 1048576 by default) to start the\n"
+              "                    next call from the articles of unchanged profits]\n"
+              "       [-costNAME: the pattern cost function, NAME among csp (classical cut\n"
+              "                    stock), ml1 (default), ml2 (multiple-length variants),\n"
+              "                    elastic2, elastic3 (elastic bin packing), vsbp10, vsbp2\n"
+              "                    (variable sized bin packing), see subprob.h]\n"
+              "       [-heur[PERIOD]: with -std, try pricing heuristics before the exact DP,\n"
+              "                    run the DP once every PERIOD (5 by default) iterations]\n"
+              "       projective cutting planes used by default, use -std to change to the standard col gen\n";
+        return EXIT_FAILURE;
+    }
+    while(argv[argc-1][0]=='-') {
+        int optionsFnd = 0;
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-si",3))) {
+            cout<<"I'll be silent, ignoring clog."<<endl;
+            clog.setstate(ios_base::failbit);                               //disable clog
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-std",4))) {
+            cout<<"I'll use old classical method."<<endl;
+            stdMethd=1;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-rnd",4))) {
+            if(strlen(argv[argc-1])==4)
+                rndmizedRunSeed = time(NULL);
+            else
+                rndmizedRunSeed = atoi(argv[argc-1]+4);
+            cout<<"I'll randomize Simplex with seed "<<rndmizedRunSeed<<endl;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-ws",3))) {
+            cout<<"I'll re-solve by dual simplex from the last basis."<<endl;
+            warmStart = 1;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-pipe",5))) {
+            cout<<"I'll separate the previous primals during each re-solve."<<endl;
+            pipelined = 1;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-stats",6))) {
+            statsFile = argv[argc-1]+6;
+            cout<<"I'll write the statistics of each iteration to "<<statsFile<<endl;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-dpthreads",10))) {
+            dpThreads = atoi(argv[argc-1]+10);
+            if(dpThreads<0) {
+                cerr<<"The number of threads of -dpthreads can not be negative\n";
+                exit(EXIT_FAILURE);
+            }
+            if(dpThreads==0)
+                dpThreads = max(1,(int)thread::hardware_concurrency());
+            cout<<"I'll share the large DP passes between "<<dpThreads<<" threads."<<endl;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-dplayers",9))) {
+            dpLayerCells = atol(argv[argc-1]+9);
+            if(dpLayerCells<0) {
+                cerr<<"The number of cells of -dplayers can not be negative\n";
+                exit(EXIT_FAILURE);
+            }
+            if(dpLayerCells==0)
+                dpLayerCells = 1L<<20;
+            cout<<"I'll keep the DP layers in at most "<<dpLayerCells<<" cells."<<endl;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-cost",5))) {
+            costMdl = costModelByName(argv[argc-1]+5);
+            if(costMdl==NULL) {
+                cerr<<"Unknown cost function "<<argv[argc-1]+5<<" of -cost\n";
+                exit(EXIT_FAILURE);
+            }
+            cout<<"I'll use the cost function "<<costMdl->name<<"."<<endl;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-heur",5))) {
+            heurPeriod = atoi(argv[argc-1]+5);
+            if(heurPeriod<0) {
+                cerr<<"The period of -heur can not be negative\n";
+                exit(EXIT_FAILURE);
+            }
+            if(heurPeriod==0)
+                heurPeriod = 5;
+            cout<<"I'll try pricing heuristics, the exact DP once every "<<heurPeriod
+                <<" iterations."<<endl;
+            argc--;
+            optionsFnd++;
+        }
+        if( (argv[argc-1][0]=='-') && (!strncmp(argv[argc-1],"-batch",6))) {
+            batchThreads = atoi(argv[argc-1]+6);
+            if(batchThreads<0) {
+                cerr<<"The number of threads of -batch can not be negative\n";
+                exit(EXIT_FAILURE);
+            }
+            argc--;
+            optionsFnd++;
+        }
+        if(optionsFnd==0) {
+            cerr<<"There is an argument starting with '-' that I can not understand\n";
+            cerr<<"Accepted arguments:[-si[lent]] [-cl[assicalOldMeth]] [-rnd[SEED]] [-ws] [-pipe] [-statsFILE]"
+                  " [-batch[THREADS]] [-dpthreads[THREADS]] [-dplayers[CELLS]] [-costNAME] [-heur[PERIOD]]\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+    if(argc>3) {
+        cerr<<"You gave me 3 arguments with no '-'. I don't understand the third.\n";
+        exit(EXIT_FAILURE);
+    }
+    if(batchThreads>=0) {
+        if(argc!=2) {
+            cerr<<"The -batch mode solves all instances, give no instance number.\n";
+            exit(EXIT_FAILURE);
+        }
+        clog.setstate(ios_base::failbit);   //the threads would interleave their messages
+        solveBatch(argv[1],batchThreads);
+        return EXIT_SUCCESS;
+    }
+    cspRun run;
+    initRun(run);
+    if(argc==2) {
+        cout<<"I take the first instance in "<<argv[1]<<endl;
+        readInstNrFromFile(0,argv[1],run.inst);
+    } else
+        readInstNrFromFile(atoi(argv[2]),argv[1],run.inst);
+    //clog<<"C="<<run.inst.C<<endl;
+    //for(int i=0;i<run.inst.n;i++) clog<<run.inst.w[i]<<" "<<run.inst.b[i]<<endl;
+
+
+    if(argc==2)
+        solveInstance(run,argv[1],0,cout,statsFile);
     else
-        cout<<"\\\\%"<<endl;
+        solveInstance(run,argv[1],atoi(argv[2]),cout,statsFile);
 }
@@ -5,10 +5,10 @@
          +------------------------------------------------------------------------*/
 #include "subprob.h"
 
-//Below one can choose between two frontpareto implementations.
-//By default, we use frontpareto version 2 (FPARETO2) when no compilation option is given
-#if !defined (FPARETO1) && ! defined (FPARETO2) 
-    #define FPARETO2
+//Below one can choose between three frontpareto implementations.
+//By default, we use frontpareto version 3 (FPARETO3) when no compilation option is given
+#if !defined (FPARETO1) && ! defined (FPARETO2) && ! defined (FPARETO3)
+    #define FPARETO3
 #endif 
 
 #ifdef FPARETO1
@@ -21,83 +21,715 @@
     #include "frontpareto2.h"
 #endif
 
+#ifdef FPARETO3
+    #define PARETOCLASS frontpareto3
+    #include "frontpareto3.h"
+#endif
+
 
 #include<climits>
 #include<cassert>
 #include<algorithm>            //for sort
 #include<cmath>
 #include<cstdlib>
+#include<cstring>
 #include<iostream>
 #include<iomanip>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<cstdint>
 using namespace std;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define DENSE_PASS_SIMD        //AVX2/AVX-512 weight sweeps, chosen at run time
+    #include<immintrin.h>
+#endif
 
 
 //#define DP_SCAN_ALL_W_RANGE  //Use this to scan all range [0..extC/C] in DP, even for 
                                //weight values not associated to patterns of that weight.
 #define EPSILON 1.0e-6
 
-//put them inside namespace
-double* bst_xbase = NULL;      //the best feasible solution found so far, truncated
-double bst_xbase_val = 0;
-namespace{
+/*-----------------------+------------------------------------+--------------------------
+                         |            COST MODELS             |
+                         +-----------------------------------*/
+//Each problem is a policy type whose members are compile-time constants; f is only
+//called to fill the cost tables of the DPs (see getWorkspace), never inside a DP pass
+struct classicalCsp{
+    static constexpr const char* name        = "csp";
+    static constexpr double      extMax      = 1;
+    static constexpr double      minPattCost = 1;
+    static constexpr double      truncFact   = 5;
+    static constexpr double      boundsFact  = 1;
+    static double f(double X){
+        return X<=1 ? 1 : INT_MAX;
+    }
+};
+struct multiLenCsp1{                 //IPOPT is a multiple of 0.2
+    static constexpr const char* name        = "ml1";
+    static constexpr double      extMax      = 1;
+    static constexpr double      minPattCost = 0.6;
+    static constexpr double      truncFact   = 5;
+    static constexpr double      boundsFact  = 5;
+    static double f(double X){
+        return X<=1 ? (X<=0.7 ? 0.6 : 1) : INT_MAX;
+    }
+};
+struct multiLenCsp2{
+    static constexpr const char* name        = "ml2";
+    static constexpr double      extMax      = 1;
+    static constexpr double      minPattCost = 0.4;
+    static constexpr double      truncFact   = 5;
+    static constexpr double      boundsFact  = 5;
+    static double f(double X){
+        return X<=1 ? (X<=0.7 ? (X<=0.5 ? 0.4 : 0.6) : 1) : INT_MAX;
+    }
+};
+template<int POW> struct elasticBp{  //f(X)=X^POW beyond the capacity
+    static constexpr const char* name        = POW==2 ? "elastic2" : "elastic3";
+    static constexpr double      extMax      = 2;
+    static constexpr double      minPattCost = 1;
+    static constexpr double      truncFact   = 5;
+    static constexpr double      boundsFact  = 1;
+    static double f(double X){
+        return X<=1 ? 1 : pow(X,POW);
+    }
+};
+template<int STEPS> struct variableSizedBp{  //bins of sizes 1/STEPS, 2/STEPS,...
+    static constexpr const char* name        = STEPS==10 ? "vsbp10" : "vsbp2";
+    static constexpr double      extMax      = 2;
+    static constexpr double      minPattCost = 1.0/STEPS;
+    static constexpr double      truncFact   = 10;
+    static constexpr double      boundsFact  = STEPS;
+    static double f(double X){
+        return ceil(STEPS*X)/STEPS;
+    }
+};
+
+template<class P> constexpr costModel makeCostModel()
+{
+    return costModel{P::name, P::extMax, P::minPattCost, P::truncFact, P::boundsFact,
+                     &P::f};
+}
+const costModel costModels[] = {
+    makeCostModel<classicalCsp>(),
+    makeCostModel<multiLenCsp1>(),
+    makeCostModel<multiLenCsp2>(),
+    makeCostModel<elasticBp<2> >(),
+    makeCostModel<elasticBp<3> >(),
+    makeCostModel<variableSizedBp<10> >(),
+    makeCostModel<variableSizedBp<2> >()
+};
 
-PARETOCLASS* states;       
+const costModel* costModelByName(const char* name)
+{
+    for(const costModel& cm : costModels)
+        if(strcmp(cm.name,name)==0)
+            return &cm;
+    return NULL;
+}
 
-int*         prev=NULL;        //when not all range [0..extC] is used, you scan the range
-int          last;             //by moving from prev in prev starting with last
 struct transition{             //transitions between states:
     int article;               //article used to perform a transition to current state
+    int mult;                  //the number of copies of article added by the transition
     transition * prec;         //prec is the precedent state
 };
 
+//A DP call can record millions of transitions. They are handed out contiguously from
+//blocks of TRANSITION_BLOCK records that are kept from one DP call to the next
+#define TRANSITION_BLOCK 4096
+struct transitionBlock{
+    transition       recs[TRANSITION_BLOCK];
+    transitionBlock* next;
+};
+struct transitionArena{
+    transitionBlock* first;
+    transitionBlock* curr;     //the block of the next transition
+    int              used;     //records of curr already handed out
+};
+struct arenaMark{              //a position in the arena: rewinding there recycles the
+    transitionBlock* curr;     //transitions handed out after it
+    int              used;
+};
 
-void eraseTransitionInfo(void* ptr)
+//The passes of generalInter over many reachable weights are shared by a team of threads
+//(see parallelInterPass). The caller of runTeam() is thread 0 of the team, the other
+//nrThreads-1 threads wait between two runs
+struct threadTeam{
+    int                nrThreads;
+    thread*            workers;
+    mutex              mtx;
+    condition_variable wakeUp;
+    condition_variable allDone;
+    long               round;   //incremented by each runTeam()
+    int                running; //the workers not done with the job of this round
+    bool               quit;
+    void             (*job)(void* arg, int t);
+    void*              arg;
+};
+struct interCand{               //a new state (cost,prof) of weight neww in generalInter
+    int                neww;
+    int                cost;
+    double             prof;
+    transition*        prec;
+};
+struct layerCell{
+    int              w;
+    double           prof;
+    transition*      trans;
+};
+
+//The memory of the DPs of an instance, sized once from extC and kept from one DP call
+//to the next. Between two calls, all states are empty and reached is all zeros: each
+//call only clears the weights it reached
+struct dpWorkspace{
+    int              size;     //extC+1
+    PARETOCLASS*     states;   //states[w]: pareto front of the states of weight w
+    uint64_t*        reached;  //when not all range [0..extC] is used, you scan the
+                               //reached weights: weight w is bit w%64 of word w/64
+    int              hiWord;   //the words of reached above hiWord are zero
+    transitionArena  arena;    //reset (not freed) at each DP call
+    //Below: the dense DP of extendedKnapskDP, indexed by weight
+    double*          extF;     //extF[w] = f(w/C), the cost of a pattern of weight w
+    int*             costMlt;  //costMlt[w] = truncMlt(extF[w]), the costs of generalInter
+    double*          prof;     //prof[w]: best profit-cost of a pattern of weight w
+    transition**     trans;    //the last transition of above pattern
+    char*            improved; //the weights whose prof the current DP pass improved
+    //Below: the layers of extendedKnapskDP kept for the next call. Layer l holds the
+    //weights reached by the passes of the articles layerOrder[0], ..., layerOrder[l]
+    int*             layerOrder;
+    double*          layerP;   //the profits of the articles in the last call
+    int              nrLayers; //the valid layers
+    int              nrToLayers;//the articles of unchanged profits come first in
+                                //layerOrder: only their layers are likely to be reused
+    long*            layerStart;//layer l: cells[layerStart[l]..layerEnd[l]), by
+    long*            layerEnd;  //decreasing weight
+    arenaMark*       layerMark;//the arena position after the transitions of layer l
+    layerCell*       cells;
+    long             capCells;
+    long             maxCells; //inst.dpLayerCells, 0 if the layers are not kept
+    //Below: the threads of the passes of generalInter, see parallelInterPass()
+    int              nrThreads;
+    threadTeam*      team;     //started at the first parallel pass
+    transitionArena* thrArenas;//thrArenas[t]: the transitions of thread t>0 (t=0: arena)
+    vector<interCand>* cands;  //cands[t]: the new states thread t computed in a pass
+    vector<int>*     added;    //added[t]: the weights where thread t inserted states
+    double*          thrTStar; //thrTStar[t]: the tStar of the states of thread t
+    int*             reach;    //the reachable weights of a pass, by decreasing weight
+    //Below: the bound of generalInter on what the remaining articles can bring, see
+    //prepareBound()
+    double*          bndOfCap; //bndOfCap[r]: the bound for a remaining capacity r
+    double*          bndVal;   //buffers: the value of each article
+    int*             bndOrder; //and the articles sorted by density
+    //Below: the profits of extendedKnapskDP, 0 for the dominated articles
+    double*          domP;
+    int*             domByW;   //buffers of dropDominated()
+    char*            domDrop;
+};
+
+//The articles handed to generalInter, one array per field (structure of arrays), each
+//array starting on a cache line. Position k holds article id[k]. A call only keeps the
+//articles of non-zero x or y that are not dominated (see loadItems): the others can not
+//lead to a better pattern
+#define CACHE_LINE 64
+struct itemTable{
+    int              n;        //the articles of the current call: positions 0..n-1
+    int*             id;
+    int*             w;
+    int*             b;
+    double*          x;        //the base of the current call, truncated
+    double*          y;        //the direction
+    double*          cut;      //the cut found by generalInter
+    int*             order;    //all articles, by decreasing key (see sortItems)
+    double*          key;      //key[i]: the sort key of article i
+    int              stale;    //bst_xbase changed since order was sorted
+    int*             byW;      //buffers of dropDominated()
+    char*            drop;
+    char*            mem;      //the block of all arrays above
+};
+
+//The pricing heuristics of sepClassicalCalcBounds, tried before the exact DP when
+//inst.heurPeriod>0: the pool holds the patterns of the best states of the last exact DPs,
+//not added to the LP, re-priced at each call against the new point
+#define PRICING_POOL_SIZE 64    //patterns in the pool, the oldest ones are replaced
+#define PRICING_POOL_NEW  8     //the best states of an exact DP that enter the pool
+struct pricingPool{
+    int              n;
+    int              nrPatts;  //at most PRICING_POOL_SIZE
+    int              next;     //the slot of the next pattern, the oldest once full
+    int*             mult;     //mult[k*n+i]: copies of article i in pattern k
+    int*             weight;   //weight[k]: the weight of pattern k
+    int*             cand;     //a pattern of the DP before it enters the pool
+    int*             byRatio;  //buffers of the greedy, see heuristicPricing()
+    int*             fill;
+    long             calls;    //calls of sepClassicalCalcBounds so far
+};
+
+namespace{
+
+//Rewinds arena to its first block, allocated at first use
+transitionArena* resetArena(transitionArena* arena)
 {
-     delete static_cast<transition*>(ptr);
+    if(arena->first==NULL){
+        arena->first       = new transitionBlock;
+        arena->first->next = NULL;
+    }
+    arena->curr = arena->first;
+    arena->used = 0;
+    return arena;
 }
-void correlatePrevs(int lastNew, int*prevNew)
+arenaMark markArena(const transitionArena* arena)
 {
-    int i = last;
-    int j = lastNew;
-    if(lastNew>last){
-        i       = lastNew;
-        prev[i] = last;
-        last    = lastNew;
+    arenaMark mark;
+    mark.curr = arena->curr;
+    mark.used = arena->used;
+    return mark;
+}
+transitionArena* rewindArena(transitionArena* arena, arenaMark mark)
+{
+    arena->curr = mark.curr;
+    arena->used = mark.used;
+    return arena;
+}
+inline transition* newTransition(transitionArena* arena, int article, int mult,
+                                 transition* prec)
+{
+    if(arena->used==TRANSITION_BLOCK){
+        if(arena->curr->next==NULL){
+            arena->curr->next       = new transitionBlock;
+            arena->curr->next->next = NULL;
+        }
+        arena->curr = arena->curr->next;
+        arena->used = 0;
     }
+    transition* t = &arena->curr->recs[arena->used++];
+    t->article    = article;
+    t->mult       = mult;
+    t->prec       = prec;
+    return t;
+}
+void teamWorker(threadTeam* team, int t)
+{
+    long seen = 0;                              //the last round done
     while(true){
-        assert(j<=i);
-        if(i==j)
-            j = prevNew[j];
-        while(prev[i]<j){
-            prev[j] = prev[i];
-            prev[i] = j;          //i  ---> prev[i]=j  ---->prev[i]
-            i       = j;          //i=prev[i]
-            j       = prevNew[j];
+        unique_lock<mutex> lock(team->mtx);
+        team->wakeUp.wait(lock,[&]{return team->quit || (team->round!=seen);});
+        if(team->quit)
+            return;
+        seen = team->round;
+        lock.unlock();
+        team->job(team->arg,t);
+        lock.lock();
+        if(--team->running==0)
+            team->allDone.notify_one();
+    }
+}
+threadTeam* newTeam(int nrThreads)
+{
+    threadTeam* team = new threadTeam;
+    team->nrThreads  = nrThreads;
+    team->round      = 0;
+    team->running    = 0;
+    team->quit       = false;
+    team->workers    = new thread[nrThreads];
+    for(int t=1;t<nrThreads;t++)
+        team->workers[t] = thread(teamWorker,team,t);
+    return team;
+}
+//job(arg,t) for all threads t of the team, returns when all are done
+void runTeam(threadTeam* team, void (*job)(void*,int), void* arg)
+{
+    {
+        lock_guard<mutex> lock(team->mtx);
+        team->job     = job;
+        team->arg     = arg;
+        team->running = team->nrThreads-1;
+        team->round++;
+    }
+    team->wakeUp.notify_all();
+    job(arg,0);
+    unique_lock<mutex> lock(team->mtx);
+    team->allDone.wait(lock,[&]{return team->running==0;});
+}
+void freeTeam(threadTeam* team)
+{
+    if(team==NULL)
+        return;
+    {
+        lock_guard<mutex> lock(team->mtx);
+        team->quit = true;
+    }
+    team->wakeUp.notify_all();
+    for(int t=1;t<team->nrThreads;t++)
+        team->workers[t].join();
+    delete[] team->workers;
+    delete team;
+}
+
+void freeArena(transitionArena* arena)
+{
+    while(arena->first!=NULL){
+        transitionBlock* toErase = arena->first;
+        arena->first             = arena->first->next;
+        delete toErase;
+    }
+}
+//The pareto fronts only need to forget their transitions, resetArena() recycles them
+void keepTransitionInfo(void*)
+{
+}
+
+//The workspace of the DPs of inst, allocated at first use
+dpWorkspace* getWorkspace(cspInstance& inst)
+{
+    const int size = (int)inst.extC+1;
+    if(inst.dp!=NULL){
+        assert(inst.dp->size==size);
+        return inst.dp;
+    }
+    dpWorkspace* ws = new dpWorkspace;
+    ws->size        = size;
+    ws->states      = new PARETOCLASS [size]();   //() not necessary, the default
+                                                  //constructor is called anyway
+    ws->reached     = new uint64_t[(size+63)/64]();
+    ws->hiWord      = 0;
+    ws->arena.first = NULL;
+    ws->extF        = new double[size];
+    ws->costMlt     = new int[size];
+    for(int i=0;i<size;i++){
+        ws->extF[i]    = inst.cost->f(i/inst.C);
+        ws->costMlt[i] = truncMlt(inst.cost,ws->extF[i]);
+    }
+    ws->prof        = new double[size];
+    ws->trans       = new transition*[size];
+    ws->improved    = new char[size];
+    ws->layerOrder  = new int[inst.n];
+    ws->layerP      = new double[inst.n];
+    for(int i=0;i<inst.n;i++){
+        ws->layerOrder[i] = i;
+        ws->layerP[i]     = 0;
+    }
+    ws->nrLayers    = 0;
+    ws->layerStart  = new long[inst.n];
+    ws->layerEnd    = new long[inst.n];
+    ws->layerMark   = new arenaMark[inst.n];
+    ws->cells       = NULL;
+    ws->capCells    = 0;
+    ws->maxCells    = max(0L,inst.dpLayerCells);
+    ws->nrThreads   = max(1,inst.dpThreads);
+    ws->team        = NULL;
+    ws->thrArenas   = new transitionArena[ws->nrThreads];
+    for(int t=0;t<ws->nrThreads;t++)
+        ws->thrArenas[t].first = NULL;
+    ws->cands       = new vector<interCand>[ws->nrThreads];
+    ws->added       = new vector<int>[ws->nrThreads];
+    ws->thrTStar    = new double[ws->nrThreads];
+    ws->reach       = new int[size];
+    ws->bndOfCap    = new double[size];
+    ws->bndVal      = new double[inst.n];
+    ws->bndOrder    = new int[inst.n];
+    ws->domP        = new double[inst.n];
+    ws->domByW      = new int[inst.n];
+    ws->domDrop     = new char[inst.n];
+    inst.dp         = ws;
+    return ws;
+}
+void freeWorkspace(dpWorkspace* ws)
+{
+    if(ws==NULL)
+        return;
+    delete[] ws->states;
+    delete[] ws->reached;
+    freeArena(&ws->arena);
+    delete[] ws->extF;
+    delete[] ws->costMlt;
+    delete[] ws->prof;
+    delete[] ws->trans;
+    delete[] ws->improved;
+    delete[] ws->layerOrder;
+    delete[] ws->layerP;
+    delete[] ws->layerStart;
+    delete[] ws->layerEnd;
+    delete[] ws->layerMark;
+    delete[] ws->cells;
+    freeTeam(ws->team);
+    for(int t=0;t<ws->nrThreads;t++)
+        freeArena(&ws->thrArenas[t]);
+    delete[] ws->thrArenas;
+    delete[] ws->cands;
+    delete[] ws->added;
+    delete[] ws->thrTStar;
+    delete[] ws->reach;
+    delete[] ws->bndOfCap;
+    delete[] ws->bndVal;
+    delete[] ws->bndOrder;
+    delete[] ws->domP;
+    delete[] ws->domByW;
+    delete[] ws->domDrop;
+    delete ws;
+}
+//The reachable weights of the DPs: the bits of ws->reached
+inline void setReached(dpWorkspace* ws, int w)
+{
+    ws->reached[w>>6] |= 1ULL<<(w&63);
+    ws->hiWord         = max(ws->hiWord,w>>6);
+}
+void clearReached(dpWorkspace* ws)
+{
+    for(int wd=0;wd<=ws->hiWord;wd++)
+        ws->reached[wd] = 0;
+    ws->hiWord = 0;
+}
+//Visits the reached weights basew of ws by decreasing weight, taking the highest bit of
+//each word by count-leading-zeros. The bits set meanwhile above basew are not visited:
+//a 0-1 pass only starts from the weights reached before it
+#define forEachReached(basew,ws)                                                 \
+    for(int wd_ = (ws)->hiWord, basew = 0; wd_>=0; wd_--)                        \
+        for(uint64_t bits_ = (ws)->reached[wd_];                                 \
+            (bits_!=0) && ((basew = 64*wd_+63-__builtin_clzll(bits_)),           \
+                           (bits_ ^= 1ULL<<(basew&63)), true); )
+//reached |= reached<<s, i.e., the weights reached by a 0-1 pass of an article of weight
+//s when no state is pruned, up to maxW. The words are shifted from the highest one, so
+//that each word is read before it is written
+void shiftOrReached(dpWorkspace* ws, int s, int maxW)
+{
+    uint64_t* r   = ws->reached;
+    const int q   = s>>6;
+    const int bit = s&63;
+    const int top = min(maxW>>6, ws->hiWord+q+1);
+    for(int wd=top;wd>=q;wd--){
+        uint64_t v = r[wd-q]<<bit;
+        if( (bit>0) && (wd>q) )
+            v |= r[wd-q-1]>>(64-bit);
+        r[wd] |= v;
+    }
+    if((maxW&63)!=63)                           //the weights above maxW
+        r[maxW>>6] &= (1ULL<<((maxW&63)+1))-1;
+    ws->hiWord = max(ws->hiWord,top);
+    while( (ws->hiWord>0) && (r[ws->hiWord]==0) )
+        ws->hiWord--;
+}
+//Empties the states reached by the last DP call and clears their bits
+void clearWorkspace(dpWorkspace* ws)
+{
+    #ifdef DP_SCAN_ALL_W_RANGE
+    for(int basew = ws->size-1; basew>=0; basew--)
+        ws->states[basew].freeMem(&keepTransitionInfo);
+    #else
+    forEachReached(basew,ws)
+        ws->states[basew].freeMem(&keepTransitionInfo);
+    #endif
+    clearReached(ws);
+}
+//Binary splitting of the demand b of an article of weight w: the DPs add the article by
+//chunks of mult=1,2,4,...,2^k,rest copies, one 0-1 pass per chunk, so that all numbers of
+//copies 0,1,...,b are reachable in O(log b) passes instead of b passes of one copy. The
+//copies beyond the extended capacity are never used
+#define forEachChunk(mult,b,w,extC)                                          \
+    for(int rest_ = min((b),(int)(extC)/(w)), mult = 1; rest_>0;             \
+                                   rest_ -= mult, mult = min(2*mult,rest_))
+
+//Dominance: take the articles by increasing weight (articles of equal weights by index)
+//and let D_j be the articles before j with p_i>p_j or, if q is not NULL, with p_i>=p_j,
+//q_i>=q_j and one of them strict. If a pattern uses j while an article of D_j has copies
+//left, replacing a copy of j by it does not increase the weight nor the cost (f never
+//decreases with the weight) and strictly improves the profits. So an optimal pattern
+//only uses j if all D_j is used up, impossible if sum_{D_j} b_i w_i + w_j > maxW: j can
+//be dropped without changing the optimum. This also drops the articles of the
+//same weight as better ones, when these ones have enough copies. A common divisor of
+//the weights needs no reduction: the passes only visit the reachable weights.
+//Sets drop[j] for the articles j<n never needed, returns their number. byW: n ints
+int dropDominated(int n, const int* w, const int* b, const double* p, const double* q,
+                  int maxW, int* byW, char* drop)
+{
+    for(int j=0;j<n;j++){
+        byW[j]  = j;
+        drop[j] = 0;
+    }
+    sort(byW, byW+n, [&](int i, int j){return (w[i]<w[j])||((w[i]==w[j])&&(i<j));});
+    int nrDrop = 0;
+    for(int k=1;k<n;k++){
+        const int j    = byW[k];
+        long      fill = w[j];                  //j and the copies of D_j seen so far
+        for(int l=0;(l<k)&&(fill<=maxW);l++){
+            const int i = byW[l];
+            const bool better = (q==NULL) ? (p[i]>p[j]) :
+                                (p[i]>=p[j])&&(q[i]>=q[j])&&((p[i]>p[j])||(q[i]>q[j]));
+            if(better)
+                fill += (long)b[i]*w[i];
+        }
+        if(fill>maxW){
+            drop[j] = 1;
+            nrDrop++;
         }
-        if(j==-1)
-            break;
-        while(j<=prev[i])
-            i = prev [i];
     }
+    return nrDrop;
 }
+
 /*---------------------------------------------------------------------------------------+
 |                                                                                        |
 |                       Random base intersection sub-problem                             |
 |                                                                                        |
 +---------------------------------------------------------------------------------------*/
-#define USE_TOUCHED                             /*can bring a minimal speed-up like 1-2%*/
+//Bounding: tStar is the best ratio cost/prof of the states built so far. Adding m_j
+//copies of articles j changes the cost of a state by at least -sum m_j X_j (the pattern
+//cost f never decreases with the weight) and its prof by sum m_j y_j, X_j being the
+//truncated x_j. So a state (cost,prof) at weight w can not lead to a ratio below tStar
+//if cost-tStar*prof > max sum m_j(X_j+tStar*y_j), s.t. sum m_j w_j <= extC-w, m_j<=b_j
+//The fractional relaxation of this knapsack over the articles i..n-1 is an upper bound:
+//prepareBound() records it for all capacities r, filling r with the articles by
+//decreasing density. It is only done again when tStar decreased by a factor BOUND_RECALC
+#define BOUND_RECALC 0.05
+void prepareBound(dpWorkspace* ws, const cspInstance& inst, const itemTable* it, int i,
+                  double tStar)
+{
+    const int* w     = it->w;
+    double*    val   = ws->bndVal;
+    int*       order = ws->bndOrder;
+    int        nr    = 0;
+    for(int j=i;j<it->n;j++){
+        val[j] = truncMlt(inst.cost,it->x[j])+tStar*it->y[j];
+        if(val[j]>0)
+            order[nr++] = j;
+    }
+    sort(order, order+nr, [&](int j1, int j2){
+                              return val[j1]*w[j2]>val[j2]*w[j1];});
+    const int maxW   = (int)inst.extC;
+    double*   bnd    = ws->bndOfCap;
+    int       r      = 0;                       //the capacity used by articles before k
+    bnd[0]           = 0;
+    for(int k=0;(k<nr)&&(r<maxW);k++){          //capacities r+1..endR: article k
+        const int    j    = order[k];
+        const double dens = val[j]/w[j];
+        const int    endR = (int)min((long)maxW, r+(long)it->b[j]*w[j]);
+        for(int r1=r+1;r1<=endR;r1++)
+            bnd[r1] = bnd[r]+(r1-r)*dens;
+        r = endR;
+    }
+    for(int r1=r+1;r1<=maxW;r1++)               //all articles fit
+        bnd[r1] = bnd[r];
+}
+
+//A pass of generalInter (mult copies of article i) shared by the team of threads, if
+//there are at least PARALLEL_DP_MIN_WEIGHTS reachable weights. Each thread takes a slice
+//of the reachable weights basew and computes the new states of the weights basew+addW
+//(read phase), before any thread inserts them (write phase): the fronts of the bases are
+//only read before the pass changes them, as in the sequential pass. A weight neww only
+//receives states from basew=neww-addW, so the threads insert in distinct fronts, in the
+//same order as the sequential pass: the resulting fronts are the same
+#define PARALLEL_DP_MIN_WEIGHTS 1024
+struct interPass{
+    const cspInstance* inst;
+    dpWorkspace*       ws;
+    const itemTable*   it;
+    int                article;
+    int                mult;
+    double             tBound;  //see generalInter
+    int                nrReach; //ws->reach[0..nrReach): the reachable weights
+    bool               insert;  //the write phase
+};
+void interPassJob(void* arg, int t)
+{
+    const interPass&   ps     = *(interPass*)arg;
+    dpWorkspace*       ws     = ps.ws;
+    PARETOCLASS*       states = ws->states;
+    const int*         cstMlt = ws->costMlt;
+    const int          maxW   = (int)ps.inst->extC;
+    const int          addW   = ps.mult*ps.it->w[ps.article];
+    const int          nrThr  = ws->team->nrThreads;
+    vector<interCand>& cands  = ws->cands[t];
+    if(!ps.insert){
+        cands.clear();
+        const int kEnd = (long)ps.nrReach*(t+1)/nrThr;
+        for(int k=(long)ps.nrReach*t/nrThr;k<kEnd;k++){
+            const int basew = ws->reach[k];
+            const int neww  = basew+addW;
+            if(neww>maxW)
+                continue;
+            int    deltaCost = cstMlt[neww]-cstMlt[basew]
+                               -ps.mult*truncMlt(ps.inst->cost,ps.it->x[ps.article]);
+            double bound     = HUGE_VAL;
+            if(ps.tBound!=HUGE_VAL)
+                bound = ws->bndOfCap[maxW-basew]+EPSILON;
+            int    baseCost;
+            double baseProf;
+            for(int cont=states[basew].first(baseCost,baseProf);
+                                cont; cont=states[basew].next(baseCost,baseProf)){
+                if(baseCost-ps.tBound*baseProf>bound)
+                    continue;                   //can not beat tStar
+                interCand c;
+                c.neww = neww;
+                c.cost = baseCost+deltaCost;
+                c.prof = baseProf+ps.mult*ps.it->y[ps.article];
+                c.prec = (transition*)states[basew].getInfoCurrElem();
+                assert(c.cost>=0);
+                cands.push_back(c);
+            }
+        }
+        return;
+    }
+    transitionArena* arena = (t==0) ? &ws->arena : &ws->thrArenas[t];
+    double&          tStar = ws->thrTStar[t];
+    vector<int>&     added = ws->added[t];
+    added.clear();
+    for(size_t k=0;k<cands.size();k++){
+        const interCand& c = cands[k];
+        if(states[c.neww].addIfHigherVal(c.cost,c.prof)){
+            states[c.neww].putInfoOnLastAdded(
+                                newTransition(arena,ps.article,ps.mult,c.prec));
+            if( (c.prof>EPSILON) && (c.cost<tStar*c.prof) )
+                tStar = c.cost/c.prof;
+            if( added.empty() || (added.back()!=c.neww) )
+                added.push_back(c.neww);
+        }
+    }
+}
+//Returns false (and does nothing) if there are too few reachable weights. Otherwise it
+//runs the pass, updates tStar and marks the new weights as reached
+bool parallelInterPass(const cspInstance& inst, dpWorkspace* ws, const itemTable* it,
+                       int i, int mult, double tBound, double& tStar)
+{
+    int nrReach = 0;
+    forEachReached(basew,ws)
+        ws->reach[nrReach++] = basew;
+    if(nrReach<PARALLEL_DP_MIN_WEIGHTS)
+        return false;
+    if(ws->team==NULL)
+        ws->team = newTeam(ws->nrThreads);
+    interPass ps = {&inst, ws, it, i, mult, tBound, nrReach, false};
+    runTeam(ws->team,interPassJob,&ps);
+    for(int t=0;t<ws->nrThreads;t++)
+        ws->thrTStar[t] = tStar;
+    ps.insert = true;
+    runTeam(ws->team,interPassJob,&ps);
+    for(int t=0;t<ws->nrThreads;t++){
+        tStar = min(tStar,ws->thrTStar[t]);
+        for(size_t k=0;k<ws->added[t].size();k++)
+            setReached(ws,ws->added[t][k]);
+    }
+    return true;
+}
 
 //              c_a - x^Ta
 //Return t=min ----------- , over all patterns a where c_a is the ptn cost
 //               y^T a
 //We'll have (x^T+ty^T )a <= c_a for all patterns a
-double generalInter(double *x, double* y, double * newCut, double&rHnd)
+//The articles, x and y are those of it, the cut is recorded in it->cut
+double generalInter(cspInstance& inst, itemTable* it, double&rHnd)
 {
+    const int     n      = it->n;
+    const double  extC   = inst.extC;
+    const int*    w      = it->w;
+    const int*    b      = it->b;
+    const double* x      = it->x;
+    const double* y      = it->y;
+    double*       newCut = it->cut;
     clog<<"*********         Start gen inter alg            *********\n";
     #ifndef NDEBUG
     for(int i=0;i<n;i++){
-        if(!(abs(x[i]-TRUNC(x[i]))<EPSILON)){
-            clog<<x[i]<<"vs truncated version "<<TRUNC(x[i])<<endl;
+        if(!(abs(x[i]-truncNear(inst.cost,x[i]))<EPSILON)){
+            clog<<x[i]<<"vs truncated version "<<truncNear(inst.cost,x[i])<<endl;
             clog<<"not right. I need truncated input. Now need exit"<<endl;
             exit(1);
         }
@@ -106,95 +738,79 @@ double generalInter(double *x, double* y, double * newCut, double&rHnd)
 
 
     /*------------                       Init Data                 --------------*/
-    transition* tNew;
-    states = new PARETOCLASS [(int)extC+1]();  //() not necessary, default constructor called 
-                                              //by default on not built-in types
-    #ifndef DP_SCAN_ALL_W_RANGE
-    static int*prevNew = new int[(int)extC+1];
-    int lastNew;
-    if(prev==NULL)
-        prev = new int[(int)extC+1];
-    last   = 0;
-    prev[last] = -1;
-    #endif
+    dpWorkspace*     ws     = getWorkspace(inst);
+    transitionArena* arena  = resetArena(&ws->arena);
+    PARETOCLASS*     states = ws->states;
+    ws->nrLayers            = 0;    //their transitions are recycled
+    for(int t=1;t<ws->nrThreads;t++)
+        resetArena(&ws->thrArenas[t]);
     assert(extC==floor(extC));
     assert(extC==ceil(extC));
-    #ifdef USE_TOUCHED
-    static int*touched=new int[(int)extC+1];
-    for(int i=0;i<(int)extC+1;i++)
-        touched[i]=0;
-    #endif
 
     //initial state
-    states[0].addIfHigherVal(TRUNC_MLT(EXT_F(0)), 0);
-    tNew           = new transition;
-    tNew->article  = -1;
-    tNew->prec     = NULL;
-    states[0].putInfoOnLastAdded((void*)tNew);
+    const int*       cstMlt = ws->costMlt;
+    setReached(ws,0);                           //the other bits are 0, see clearWorkspace
+    states[0].addIfHigherVal(cstMlt[0], 0);
+    states[0].putInfoOnLastAdded((void*)newTransition(arena,-1,0,NULL));
+    double tStar  = HUGE_VAL;                   //no state of positive prof yet
+    double tBound = HUGE_VAL;                   //the tStar of the last prepareBound()
 
 
     /*------------                MAIN DP scheme calc              --------------*/
     for(int i=0;i<n;i++)
-      if( (x[i]!=0) || (y[i]!=0) )
-        for(int mult=0;mult<b[i];mult++){
+      if( (x[i]!=0) || (y[i]!=0) ){
+        if(tStar<tBound*(1-BOUND_RECALC)){      //the bound of an older tBound and more
+            prepareBound(ws,inst,it,i,tStar);   //articles is weaker, but still valid
+            tBound = tStar;
+        }
+        forEachChunk(mult,b[i],w[i],extC){
+            #ifndef DP_SCAN_ALL_W_RANGE
+            if( (ws->nrThreads>1) && parallelInterPass(inst,ws,it,i,mult,tBound,tStar) )
+                continue;
+            #endif
             #ifdef DP_SCAN_ALL_W_RANGE
             double tmp;
             for(int basew = extC; basew>=0; basew--)
                 if (states[basew].first(tmp))                     {
             #else
-            int j = -1;
-            lastNew = 0;
-            for(int basew = last; basew >= 0; basew = prev[basew]){
+            forEachReached(basew,ws)                              {
             #endif
-                int neww = basew+w[i];
+                int neww = basew+mult*w[i];
                 if(neww<=extC){
                       //Generate all new states at neww weight
                       double baseProf=-1; 
                       int    baseCost=-1;
-                      int    deltaCost = -TRUNC_MLT(EXT_F(basew/C)) 
-                                         +TRUNC_MLT(EXT_F(neww/C))-TRUNC_MLT(x[i]);
+                      int    deltaCost = cstMlt[neww]-cstMlt[basew]
+                                         -mult*truncMlt(inst.cost,x[i]);
                       int    cont;              //signals if below for can continue
+                      double bound  = HUGE_VAL; //no pruning before tStar is finite
+                      if(tBound!=HUGE_VAL)
+                          bound = ws->bndOfCap[(int)extC-basew]+EPSILON;
                       for(cont=states[basew].first(baseCost,baseProf); 
                                   cont; cont=states[basew].next(baseCost,baseProf)){
+                            if(baseCost-tBound*baseProf>bound)
+                                continue;       //can not beat tStar
                             int newCost = baseCost + deltaCost;
                             #ifndef NDEBUG
                             if(newCost<0)
                                 clog<<"Problem newCost="<<newCost<<endl;
                             assert(newCost>=0);
                             #endif
-                            double newProf = baseProf+y[i];
+                            double newProf = baseProf+mult*y[i];
                             if(states[neww].addIfHigherVal(newCost,newProf)){
-                                 tNew = new transition;
-                                 tNew->article = i;
-                                 tNew->prec = (transition*)states[basew].getInfoCurrElem();
-                                 states[neww].putInfoOnLastAdded((void*)tNew);
-                            }
+                                 transition* prec =
+                                            (transition*)states[basew].getInfoCurrElem();
+                                 states[neww].putInfoOnLastAdded(
+                                            newTransition(arena,i,mult,prec));
+                                 if( (newProf>EPSILON) && (newCost<tStar*newProf) )
+                                     tStar = newCost/newProf;
+                                 setReached(ws,neww);   //not if all states of
+                            }                           //basew are pruned
                       }
-                      #ifndef DP_SCAN_ALL_W_RANGE
-                          if(lastNew == 0){
-                              lastNew = neww;
-                              j       = lastNew;
-                          }else
-                              prevNew[j] = neww;
-                          //can use touched to skip j=neww, reducing prevNew
-                          #ifdef USE_TOUCHED
-                          if((!touched[neww]))
-                          #endif
-                              j = neww;
-                      #endif /* ndef DP_SCAN_ALL_W_RANGE */
                 } /*end neww<=extC */
             } /* end scan basew */
-
-            #ifndef DP_SCAN_ALL_W_RANGE
-                assert(j>=0);
-                prevNew[j] = -1;
-                correlatePrevs(lastNew,prevNew);
-                #ifdef USE_TOUCHED
-                    for(int basew = lastNew; basew >= 0; basew = prevNew[basew])
-                        touched[basew] = 1;
-                #endif
-            #endif
-        } /* end scan all multiplicities of article i */
+        } /* end scan all chunks of copies of article i */
+      }
 
 
     /*---------------              find optimum state             ---------------*/
@@ -207,7 +823,7 @@ double generalInter(double *x, double* y, double * newCut, double&rHnd)
     #ifdef DP_SCAN_ALL_W_RANGE
     for(int basew = extC; basew>=0; basew--)              {
     #else
-    for(int basew = last; basew >= 0; basew = prev[basew]){
+    forEachReached(basew,ws)                              {
     #endif
         for(int cont=states[basew].first(costLocl,profLocl); 
                                 cont; cont=states[basew].next(costLocl,profLocl)) {
@@ -247,11 +863,11 @@ double generalInter(double *x, double* y, double * newCut, double&rHnd)
     /*===         Fill newCut using precedence relations between states       ===*/
     for(int i=0;i<n;i++)
         newCut[i] = 0;
-    rHnd = EXT_F(bestw/C);
+    rHnd = ws->extF[bestw];
 
 #ifdef NDEBUG
     while(tranBest->article!=-1){               //article=-1 only in states[0]
-        newCut[tranBest->article]++;
+        newCut[tranBest->article] += tranBest->mult;
         tranBest         = tranBest->prec;
     }
 #else
@@ -259,33 +875,26 @@ double generalInter(double *x, double* y, double * newCut, double&rHnd)
     double verifyCost   = rHnd;
     clog<<"Using articles: ";
     while(tranBest->article!=-1){               //article=-1 only in states[0]
-        newCut[tranBest->article]++;
-        clog<<","<<tranBest->article;
-        verifyProfit += y[tranBest->article];
-        verifyCost   -= x[tranBest->article];
+        newCut[tranBest->article] += tranBest->mult;
+        clog<<","<<tranBest->article<<"x"<<tranBest->mult;
+        verifyProfit += tranBest->mult*y[tranBest->article];
+        verifyCost   -= tranBest->mult*x[tranBest->article];
         tranBest         = tranBest->prec;
     }
     clog<<endl;
     clog<<"   verify profit="<<verifyProfit<<" calculated profit="<<bestProf<<endl;
     assert(abs(verifyProfit-bestProf)<EPSILON);
     clog<<"   verify cost non trunc mult="<<(verifyCost)<<":";
-    clog<<"   verify cost multiplied="<<TRUNC_MLT(verifyCost)<<endl;
-    assert(abs(TRUNC_MLT(verifyCost)-bestCost)<EPSILON);
+    clog<<"   verify cost multiplied="<<truncMlt(inst.cost,verifyCost)<<endl;
+    assert(abs(truncMlt(inst.cost,verifyCost)-bestCost)<EPSILON);
 #endif /*NDEBUG*/
 
 
-    /*-----------------                 free all mem         --------------------*/
-    #ifdef DP_SCAN_ALL_W_RANGE
-    for(int basew = extC; basew>=0; basew--)              
-        states[basew].freeMem(&eraseTransitionInfo);
-    #else
-    for(int basew = last; basew >= 0; basew = prev[basew])
-        states[basew].freeMem(&eraseTransitionInfo);
-    #endif
-    delete[] states;
+    /*-----------------      empty the states for the next call    ---------------*/
+    clearWorkspace(ws);
     if(bestProf<=0)                                  //open direction, quite strange
         return INT_MAX;                              //for this problem
-    return ((double)bestCost)/(bestProf*TRUNC_FACT);
+    return ((double)bestCost)/(bestProf*inst.cost->truncFact);
 }
 
 /*---------------------------------------------------------------------------------------+
@@ -294,189 +903,538 @@ double generalInter(double *x, double* y, double * newCut, double&rHnd)
 |                                                                                        |
 +---------------------------------------------------------------------------------------*/
 
-//Almost everything is global below, don't use ::
+//Once 1/DENSE_DP_FILL of the weights are reachable, the DP passes scan all weights (see
+//densePass below, vectorized) instead of following the list of reachable weights
+#define DENSE_DP_FILL 4
+
+//A dense 0-1 pass adding addW/addProf to all weights neww from maxW down to addW:
+//    prof[neww] = max(prof[neww], prof[neww-addW]+f[neww-addW]+addProf-f[neww])
+//improved[neww] records if the max is the second term. Scanning downwards,
+//prof[neww-addW] is read before any write of this pass reaches it, so the iterations are
+//independent.
+//The SIMD versions compute the same sums in the same order, hence the same values
+typedef void (*densePassFunc)(double*prof, const double*f, char*improved, int addW,
+                              double addProf, int maxW);
+static void densePassScalar(double*prof, const double*f, char*improved, int addW,
+                            double addProf, int maxW)
+{
+    for(int neww=maxW;neww>=addW;neww--){
+        double newProf = prof[neww-addW]+f[neww-addW]+addProf-f[neww];
+        improved[neww] = (newProf>prof[neww]);
+        prof[neww]     = improved[neww] ? newProf : prof[neww];
+    }
+}
+#ifdef DENSE_PASS_SIMD
+//blocks of 4 weights [neww-3,neww] going down, each block is loaded before it is stored,
+//the weights below addW+3 are left to the scalar version
+__attribute__((target("avx2")))
+static void densePassAvx2(double*prof, const double*f, char*improved, int addW,
+                          double addProf, int maxW)
+{
+    const __m256d vAddProf = _mm256_set1_pd(addProf);
+    int neww = maxW;
+    for(;neww-3>=addW;neww-=4){
+        const int lo      = neww-3;
+        __m256d   newProf = _mm256_add_pd(_mm256_loadu_pd(prof+lo-addW),
+                                          _mm256_loadu_pd(f+lo-addW));
+        newProf           = _mm256_sub_pd(_mm256_add_pd(newProf,vAddProf),
+                                          _mm256_loadu_pd(f+lo));
+        __m256d   oldProf = _mm256_loadu_pd(prof+lo);
+        __m256d   higher  = _mm256_cmp_pd(newProf,oldProf,_CMP_GT_OQ);
+        _mm256_storeu_pd(prof+lo,_mm256_blendv_pd(oldProf,newProf,higher));
+        const int mask    = _mm256_movemask_pd(higher);
+        for(int k=0;k<4;k++)
+            improved[lo+k] = (mask>>k)&1;
+    }
+    densePassScalar(prof,f,improved,addW,addProf,neww);
+}
+//the same with blocks of 8 weights
+__attribute__((target("avx512f")))
+static void densePassAvx512(double*prof, const double*f, char*improved, int addW,
+                            double addProf, int maxW)
+{
+    const __m512d vAddProf = _mm512_set1_pd(addProf);
+    int neww = maxW;
+    for(;neww-7>=addW;neww-=8){
+        const int lo      = neww-7;
+        __m512d   newProf = _mm512_add_pd(_mm512_loadu_pd(prof+lo-addW),
+                                          _mm512_loadu_pd(f+lo-addW));
+        newProf           = _mm512_sub_pd(_mm512_add_pd(newProf,vAddProf),
+                                          _mm512_loadu_pd(f+lo));
+        __m512d   oldProf = _mm512_loadu_pd(prof+lo);
+        __mmask8  higher  = _mm512_cmp_pd_mask(newProf,oldProf,_CMP_GT_OQ);
+        _mm512_storeu_pd(prof+lo,_mm512_mask_blend_pd(higher,oldProf,newProf));
+        for(int k=0;k<8;k++)
+            improved[lo+k] = (higher>>k)&1;
+    }
+    densePassScalar(prof,f,improved,addW,addProf,neww);
+}
+#endif
+//the widest version the cpu running the program supports, selected once at start-up
+static densePassFunc selectDensePass()
+{
+    #ifdef DENSE_PASS_SIMD
+    __builtin_cpu_init();                       //we may run before the constructor
+    if(__builtin_cpu_supports("avx512f"))       //that initializes the cpu features
+        return densePassAvx512;
+    if(__builtin_cpu_supports("avx2"))
+        return densePassAvx2;
+    #endif
+    return densePassScalar;
+}
+static const densePassFunc densePass = selectDensePass();
+
+//Incremental mode of extendedKnapskDP (inst.dpLayerCells>0, see -dplayers): it keeps,
+//after the passes of each article, the weights it reached. The next call starts again
+//from the last such layer whose articles kept their profits. A layer costs one cell per
+//reached weight, all layers of an instance at most dpLayerCells cells. It is off by
+//default: the layers that can be reused are the first ones, with few reached weights,
+//while most of the DP time goes to the last passes, over many weights. On vb50c1 -std, a
+//quarter of the layers is reused but the passes only save 3% of their work, less than
+//what it costs to keep the layers
+//The number of layers of the last call that extendedKnapskDP can take again: those of
+//the first articles in layerOrder whose profits did not change. The articles after these
+//are reordered to put first those of unchanged profit, so that the articles of stable
+//profits gather at the beginning and the next calls can reuse more layers
+int reusableLayers(dpWorkspace* ws, const double* p, int n)
+{
+    int*    order  = ws->layerOrder;
+    double* layerP = ws->layerP;
+    int     k      = 0;
+    if(ws->maxCells==0){                        //keep the articles in their order
+        ws->nrToLayers = 0;
+        return 0;
+    }
+    while( (k<ws->nrLayers) && (layerP[order[k]]==p[order[k]]) )
+        k++;
+    int*    changed = stable_partition(order+k, order+n,
+                                       [&](int i){return layerP[i]==p[i];});
+    for(int i=0;i<n;i++)
+        layerP[i] = p[i];
+    ws->nrLayers   = k;
+    ws->nrToLayers = changed-order;
+    return k;
+}
+//Sets prof, trans and the reached weights (all zeros before) to the weights of layer l,
+//returns the number of these reached weights
+int restoreLayer(dpWorkspace* ws, int l, int maxW)
+{
+    double*      prof  = ws->prof;
+    transition** trans = ws->trans;
+    for(int w=0;w<=maxW;w++)
+        prof[w] = -HUGE_VAL;
+    for(long c=ws->layerStart[l];c<ws->layerEnd[l];c++){
+        const int w = ws->cells[c].w;
+        prof[w]     = ws->cells[c].prof;
+        trans[w]    = ws->cells[c].trans;
+        setReached(ws,w);
+    }
+    assert(ws->reached[0]&1);                   //weight 0 is always reached
+    return ws->layerEnd[l]-ws->layerStart[l];
+}
+//Records layer l, i.e., the weights reached so far. While the passes are sparse, they are
+//the nrReached weights marked in ws->reached; the dense passes do not count them.
+//sameAsPrev: no pass since layer l-1
+//Returns false if the cells would exceed ws->maxCells
+bool keepLayer(dpWorkspace* ws, int l, bool sameAsPrev, int maxW, int nrReached)
+{
+    const double*      prof  = ws->prof;
+    transition* const* trans = ws->trans;
+    if( (l>0) && sameAsPrev ){
+        ws->layerStart[l] = ws->layerStart[l-1];
+        ws->layerEnd[l]   = ws->layerEnd[l-1];
+        ws->layerMark[l]  = ws->layerMark[l-1];
+        return true;
+    }
+    const bool dense = (nrReached*DENSE_DP_FILL>maxW);  //ws->reached is not kept
+    if(dense){
+        nrReached = 0;
+        for(int w=maxW;w>=0;w--)
+            nrReached += (prof[w]!=-HUGE_VAL);
+    }
+    long c = (l==0) ? 0 : ws->layerEnd[l-1];
+    if(c+nrReached>ws->capCells){
+        if(c+nrReached>ws->maxCells)
+            return false;
+        long capCells = max(2*ws->capCells, c+nrReached);
+        capCells      = min(capCells, ws->maxCells);
+        layerCell* bigger = new layerCell[capCells];
+        for(long i=0;i<c;i++)
+            bigger[i] = ws->cells[i];
+        delete[] ws->cells;
+        ws->cells    = bigger;
+        ws->capCells = capCells;
+    }
+    ws->layerStart[l] = c;
+    if(dense){
+        for(int w=maxW;w>=0;w--)
+            if(prof[w]!=-HUGE_VAL){
+                ws->cells[c].w     = w;
+                ws->cells[c].prof  = prof[w];
+                ws->cells[c].trans = trans[w];
+                c++;
+            }
+    }else
+        forEachReached(w,ws){
+            ws->cells[c].w     = w;
+            ws->cells[c].prof  = prof[w];
+            ws->cells[c].trans = trans[w];
+            c++;
+        }
+    assert(c-ws->layerStart[l]==nrReached);
+    ws->layerEnd[l] = c;
+    ws->layerMark[l]= markArena(&ws->arena);
+    return true;
+}
+
 //cost is the cost of the pattern material, arising in rHnd of constraint
 //returns the best profit including cost, i.e., profit/value of articles - pattern cost
-double extendedKnapskDP(double *p, double * newCut, double&rHnd)
+//The cost of a pattern only depends on its weight, so the front of each weight would only
+//hold one state: flat arrays indexed by weight replace the pareto fronts of generalInter.
+//The articles are added in the order ws->layerOrder, starting after the layers of the
+//last call that can be reused (see reusableLayers). The dominated articles are skipped
+//as if their profits were 0 (see dropDominated)
+double extendedKnapskDP(cspInstance& inst, double *p, double * newCut, double&rHnd)
 {
+    const int    n    = inst.n;
+    const double extC = inst.extC;
+    const int*   w    = inst.w;
+    const int*   b    = inst.b;
     clog<<"---------         Start sep alg            ---------\n";
     /*============                       Init Data                 ==============*/
-    transition* tNew;
-    states = new PARETOCLASS [(int)extC+1]();//() not necessary, default constructor 
-                                            //called by default on not built-in types
-    #ifndef DP_SCAN_ALL_W_RANGE
-    int lastNew;
-    int*prevNew;
-    prev   = new int[(int)extC+1];
-    prevNew= new int[(int)extC+1];
-    last   = 0;
-    prev[last] = -1;
-    #endif
+    dpWorkspace*     ws       = getWorkspace(inst);
+    transitionArena* arena;
+    const double*    f        = ws->extF;
+    double*          prof     = ws->prof;
+    transition**     trans    = ws->trans;
+    char*            improved = ws->improved;
+    const int        maxW     = (int)extC;
+    const int*       order    = ws->layerOrder;
+    int              nrReached= 1;              //the bits of ws->reached, as in
+                                                //generalInter
     assert(extC==floor(extC));
     assert(extC==ceil(extC));
 
-    //initial state
-    states[0].addIfHigherVal(TRUNC_MLT(EXT_F(0)),0-EXT_F(0));
-    tNew           = new transition;
-    tNew->article  = -1;
-    tNew->prec     = NULL;
-    states[0].putInfoOnLastAdded((void*)tNew);
+    const int nrDrop = dropDominated(n,w,b,p,NULL,maxW,ws->domByW,ws->domDrop);
+    clog<<"Dropping "<<nrDrop<<" dominated articles out of "<<n<<endl;
+    for(int i=0;i<n;i++)
+        ws->domP[i] = ws->domDrop[i] ? 0 : p[i];
+    p = ws->domP;
+    const int firstL = reusableLayers(ws,p,n);
+    clog<<"Reusing the layers of "<<firstL<<" articles out of "<<n<<endl;
+    if(firstL>0){
+        nrReached = restoreLayer(ws,firstL-1,maxW);
+        arena     = rewindArena(&ws->arena,ws->layerMark[firstL-1]);
+    }else{                                      //initial state, the other weights are
+        arena    = resetArena(&ws->arena);      //not reachable yet
+        setReached(ws,0);
+        prof[0]  = 0-f[0];
+        trans[0] = newTransition(arena,-1,0,NULL);
+        for(int neww=1;neww<=maxW;neww++)
+            prof[neww] = -HUGE_VAL;             //-inf+anything is never higher
+    }
 
     /*------------                MAIN DP scheme calc              --------------*/
-    for(int i=0;i<n;i++)
+    for(int l=firstL;l<n;l++){
+      const int i = order[l];
       if(p[i]!=0)
-        for(int mult=0;mult<b[i];mult++){
-            #ifdef DP_SCAN_ALL_W_RANGE
-            double tmp;
-            for(int basew = extC; basew>=0; basew--)
-                if (states[basew].first(tmp))                     {
-            #else
-            int j = -1;
-            lastNew = 0;
-            for(int basew = last; basew >= 0; basew = prev[basew]){
-            #endif
-                int neww = basew+w[i];
-                if(neww<=extC){
-                    double baseProf=-1; states[basew].first(baseProf);
-                    int    newCost = TRUNC_MLT(EXT_F(neww/C));
-                    double newProf = baseProf+EXT_F(basew/C)+p[i]-EXT_F(neww/C);
-                    if(states[neww].addIfHigherVal(newCost,newProf)){
-                         tNew = new transition;
-                         tNew->article = i;
-                         tNew->prec    = (transition*)states[basew].getInfoCurrElem();
-                         states[neww].putInfoOnLastAdded((void*)tNew);
-                    }
-                    #ifndef DP_SCAN_ALL_W_RANGE
-                    if(lastNew == 0){
-                        lastNew = neww;
-                        j       = lastNew;
-                    }else{
-                        prevNew[j] = neww;
-                    }
-                    //can use touched to skip j=neww, reducing prevNew
-                    j = neww;
-                    #endif
+        forEachChunk(mult,b[i],w[i],extC){
+            const int    addW    = mult*w[i];
+            const double addProf = mult*p[i];
+            if(nrReached*DENSE_DP_FILL>maxW){   //dense 0-1 pass scanning all weights
+                densePass(prof,f,improved,addW,addProf,maxW);
+                for(int neww=maxW;neww>=addW;neww--)//trans[neww-addW] is still the
+                    if(improved[neww])              //one from before the pass
+                        trans[neww] = newTransition(arena,i,mult,trans[neww-addW]);
+                continue;                       //no need to keep ws->reached
+            }
+            //sparse pass over the reachable weights, as in generalInter
+            forEachReached(basew,ws){
+                int neww = basew+addW;
+                if(neww>maxW)
+                    continue;
+                double newProf = prof[basew]+f[basew]+addProf-f[neww];
+                if(newProf>prof[neww]){
+                    if(prof[neww]==-HUGE_VAL)
+                        nrReached++;
+                    prof[neww]  = newProf;
+                    trans[neww] = newTransition(arena,i,mult,trans[basew]);
                 }
             }
-            #ifndef DP_SCAN_ALL_W_RANGE
-            assert(j>=0);
-            prevNew[j] = -1;
-            correlatePrevs(lastNew,prevNew);
-            #endif
+            shiftOrReached(ws,addW,maxW);       //no state is pruned
         }
+      if( (ws->nrLayers==l) && (l<ws->nrToLayers)
+                            && keepLayer(ws,l,p[i]==0,maxW,nrReached) )
+          ws->nrLayers = l+1;
+    }
+
+    clearReached(ws);                           //all zeros for the next call
 
     /*---------------              find optimum state             ---------------*/
-    transition* tranBest;
-    int bstWeight = 0;
+    int bstWeight   = 0;
     double bestProf = INT_MIN;
-    double profLocl = INT_MIN;
-    #ifdef DP_SCAN_ALL_W_RANGE
-    for(int basew = extC; basew>=0; basew--)              {
-    #else
-    for(int basew = last; basew >= 0; basew = prev[basew]){
-    #endif
-        if(states[basew].first(profLocl)){
-            if(profLocl>bestProf){
-                bstWeight  = basew;
-                bestProf   = profLocl;
-            }
-            //clog<<basew<<":"<<profLocl<<"   ";
+    for(int basew = maxW; basew>=0; basew--)
+        if(prof[basew]>bestProf){
+            bstWeight  = basew;
+            bestProf   = prof[basew];
         }
-    }
-    //clog<<endl;
     clog<<"bstStateIdx="<<bstWeight<<"of profit-cost (rHand)"<<bestProf<<endl;
-    assert(profLocl>=INT_MIN);
 
     /*------      Fill newCut using precedence relations between states    ------*/
     for(int i=0;i<n;i++)
         newCut[i] = 0;
-    rHnd = EXT_F(bstWeight/C);
-    states[bstWeight].first(profLocl);
-    tranBest = (transition*)states[bstWeight].getInfoCurrElem();
+    rHnd = ws->extF[bstWeight];
+    transition* tranBest = trans[bstWeight];
     double verifyProfit = 0;
     clog<<"Using articles: ";
     while(tranBest->article!=-1){               //article=-1 only in states[0]
-        newCut[tranBest->article]++;
-        clog<<","<<tranBest->article;
-        verifyProfit += p[tranBest->article];
+        newCut[tranBest->article] += tranBest->mult;
+        clog<<","<<tranBest->article<<"x"<<tranBest->mult;
+        verifyProfit += tranBest->mult*p[tranBest->article];
         tranBest         = tranBest->prec;
     }
     clog<<"\nverify profit-cost="<<verifyProfit-rHnd<<endl;
     assert(abs(verifyProfit-rHnd-bestProf)<EPSILON);
-
-    /*-----------------                 free all mem         --------------------*/
-    #ifdef DP_SCAN_ALL_W_RANGE
-    for(int basew = extC; basew>=0; basew--)              
-        states[basew].freeMem(&eraseTransitionInfo);
-    delete[] states;
     return bestProf;
-    #else
-    for(int basew = last; basew >= 0; basew = prev[basew])
-        states[basew].freeMem(&eraseTransitionInfo);
-    delete[] states;
-    delete[] prev;
-    delete[] prevNew;
-    return bestProf;
-    #endif
 }
 
 /*-----------------------+------------------------------------+--------------------------
-                         |            SORT FUNCTIONS          |
+                         |             ITEM TABLE             |
                          +-----------------------------------*/
-//x[i] = x[f[i]] 
-template<typename T>
-inline void reshuffle(T*x, int*f)
+//the bytes of nr elements of size sz, rounded up to whole cache lines
+inline size_t lineBytes(int nr, size_t sz)
 {
-    T *xcpy = new T[n];
-    for(int i=0;i<n;i++)
-        xcpy[i] = x[i];
-    for(int i=0;i<n;i++)
-        x[i] = xcpy[f[i]];
-    delete[] xcpy;
+    return (nr*sz+CACHE_LINE-1)/CACHE_LINE*CACHE_LINE;
+}
+itemTable* newItemTable(int nrArticles)
+{
+    const size_t ints = lineBytes(nrArticles,sizeof(int));
+    const size_t dbls = lineBytes(nrArticles,sizeof(double));
+    itemTable*   it   = new itemTable;
+    it->mem           = (char*)aligned_alloc(CACHE_LINE, 5*ints+4*dbls+
+                                                         lineBytes(nrArticles,1));
+    char*        p    = it->mem;
+    it->id            = (int*)p;     p += ints;
+    it->w             = (int*)p;     p += ints;
+    it->b             = (int*)p;     p += ints;
+    it->order         = (int*)p;     p += ints;
+    it->byW           = (int*)p;     p += ints;
+    it->x             = (double*)p;  p += dbls;
+    it->y             = (double*)p;  p += dbls;
+    it->cut           = (double*)p;  p += dbls;
+    it->key           = (double*)p;  p += dbls;
+    it->drop          = p;
+    it->n             = 0;
+    it->stale         = 1;
+    return it;
+}
+void freeItemTable(itemTable* it)
+{
+    if(it==NULL)
+        return;
+    free(it->mem);
+    delete it;
+}
+//Sorts all articles by decreasing w[i]/(1+bst_xbase[i]). The order only depends on
+//bst_xbase: it is sorted again once bst_xbase changed
+void sortItems(itemTable* it, const cspInstance& inst)
+{
+    double* key = it->key;
+    for(int i=0;i<inst.n;i++){
+        it->order[i] = i;
+        key[i]       = inst.w[i]/(1+inst.bst_xbase[i]);
+    }
+    sort(it->order, it->order+inst.n, [&](int i, int j){return key[i]>key[j];});
+    it->stale = 0;
+}
+//Fills the table with the articles of non-zero base or direction, in the sorted order,
+//and drops the dominated ones: a copy of a heavier article of lower base and direction
+//can be replaced by one of a lighter article, decreasing the cost c_a-x^Ta of the
+//pattern or increasing its profit y^Ta
+void loadItems(itemTable* it, const cspInstance& inst, const double* base,
+               const double* direct)
+{
+    int k = 0;
+    for(int l=0;l<inst.n;l++){
+        const int i = it->order[l];
+        if( (base[i]==0) && (direct[i]==0) )
+            continue;
+        it->id[k] = i;
+        it->w[k]  = inst.w[i];
+        it->b[k]  = inst.b[i];
+        it->x[k]  = base[i];
+        it->y[k]  = direct[i];
+        k++;
+    }
+    const int nrDrop = dropDominated(k,it->w,it->b,it->x,it->y,(int)inst.extC,it->byW,
+                                     it->drop);
+    clog<<"Dropping "<<nrDrop<<" dominated articles out of "<<k<<endl;
+    if(nrDrop>0){
+        int m = 0;
+        for(int l=0;l<k;l++)
+            if(!it->drop[l]){
+                it->id[m] = it->id[l];
+                it->w[m]  = it->w[l];
+                it->b[m]  = it->b[l];
+                it->x[m]  = it->x[l];
+                it->y[m]  = it->y[l];
+                m++;
+            }
+        k = m;
+    }
+    it->n = k;
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |         HEURISTIC PRICING          |
+                         +-----------------------------------*/
+pricingPool* newPricingPool(int nrArticles)
+{
+    pricingPool* pool = new pricingPool;
+    pool->n           = nrArticles;
+    pool->nrPatts     = 0;
+    pool->next        = 0;
+    pool->mult        = new int[PRICING_POOL_SIZE*nrArticles];
+    pool->weight      = new int[PRICING_POOL_SIZE];
+    pool->cand        = new int[nrArticles];
+    pool->byRatio     = new int[nrArticles];
+    pool->fill        = new int[nrArticles];
+    pool->calls       = 0;
+    return pool;
+}
+void freePricingPool(pricingPool* pool)
+{
+    if(pool==NULL)
+        return;
+    delete[] pool->mult;
+    delete[] pool->weight;
+    delete[] pool->cand;
+    delete[] pool->byRatio;
+    delete[] pool->fill;
+    delete pool;
+}
+//Adds to the pool the patterns of the PRICING_POOL_NEW most profitable weights reached by
+//the last call of extendedKnapskDP, except the empty pattern and bstWeight, the weight of
+//the pattern it returned (that becomes a cut of the LP). A pattern already in the pool is
+//not added again
+void poolDpPatterns(pricingPool* pool, dpWorkspace* ws, int maxW, int bstWeight)
+{
+    const int     n    = pool->n;
+    const double* prof = ws->prof;
+    int           top[PRICING_POOL_NEW];        //by decreasing prof
+    int           nrTop = 0;
+    for(int wt=1;wt<=maxW;wt++){
+        if( (wt==bstWeight) || (prof[wt]==-HUGE_VAL) )
+            continue;
+        if( (nrTop==PRICING_POOL_NEW) && (prof[wt]<=prof[top[nrTop-1]]) )
+            continue;
+        int k = min(nrTop,PRICING_POOL_NEW-1);  //the last one drops out if full
+        while( (k>0) && (prof[top[k-1]]<prof[wt]) ){
+            top[k] = top[k-1];
+            k--;
+        }
+        top[k] = wt;
+        nrTop  = min(nrTop+1,PRICING_POOL_NEW);
+    }
+    int* m = pool->cand;                        //the slot next is only overwritten
+    for(int t=0;t<nrTop;t++){                   //by a pattern not in the pool
+        for(int i=0;i<n;i++)
+            m[i] = 0;
+        for(transition* tr=ws->trans[top[t]];tr->article!=-1;tr=tr->prec)
+            m[tr->article] += tr->mult;
+        bool known = false;                     //the same pattern from an earlier call
+        for(int k=0;(k<pool->nrPatts)&&(!known);k++)
+            known = (pool->weight[k]==top[t])
+                    && (memcmp(pool->mult+k*n,m,n*sizeof(int))==0);
+        if(known)
+            continue;
+        memcpy(pool->mult+pool->next*n,m,n*sizeof(int));
+        pool->weight[pool->next] = top[t];
+        pool->next               = (pool->next+1)%PRICING_POOL_SIZE;
+        pool->nrPatts            = min(pool->nrPatts+1,PRICING_POOL_SIZE);
+    }
+}
+#ifndef NDEBUG
+//Checks that weight[k] is the weight of mult[k] for all patterns k of the pool, for the
+//article weights w
+void checkPoolWeights(const pricingPool* pool, const int* w)
+{
+    const int n = pool->n;
+    for(int k=0;k<pool->nrPatts;k++){
+        int wk = 0;
+        for(int i=0;i<n;i++)
+            wk += pool->mult[k*n+i]*w[i];
+        assert(wk==pool->weight[k]);
+    }
 }
-//x[f[i]] = x[i] 
-template<typename T>
-inline void reshuffleinv(T*x, int*f)
+#endif
+//Returns the best reduced profit p^Ta-c_a of the patterns a of the pool and of a greedy
+//fill, recording the best a in newCut and c_a in rHnd. The greedy takes the articles by
+//decreasing p_i/w_i, each with as many copies as fit; c_a is not linear in the weight,
+//so it keeps the best prefix of the fill
+double heuristicPricing(cspInstance& inst, const double* p, double* newCut, double&rHnd)
 {
-    T *xcpy = new T[n];
+    const int     n    = inst.n;
+    const int*    w    = inst.w;
+    const int*    b    = inst.b;
+    const int     maxW = (int)inst.extC;
+    const double* f    = getWorkspace(inst)->extF;
+    pricingPool*  pool = inst.pool;
+    double        bestVal  = -HUGE_VAL;
+    int           bestPatt = -1;
+    for(int k=0;k<pool->nrPatts;k++){
+        const int* m   = pool->mult+k*n;
+        double     val = -f[pool->weight[k]];
+        for(int i=0;i<n;i++)
+            val += m[i]*p[i];
+        if(val>bestVal){
+            bestVal  = val;
+            bestPatt = k;
+        }
+    }
+
+    int* byRatio = pool->byRatio;
+    int* fill    = pool->fill;
+    int  nrPos   = 0;
     for(int i=0;i<n;i++)
-        xcpy[i] = x[i];
+        if(p[i]>EPSILON)
+            byRatio[nrPos++] = i;
+    sort(byRatio, byRatio+nrPos, [&](int i, int j){return p[i]*w[j]>p[j]*w[i];});
+    int    fillW    = 0;
+    double fillProf = 0;
+    int    bestL    = -1;                       //the best prefix is byRatio[0..bestL]
+    int    bestW    = 0;
+    for(int l=0;l<nrPos;l++){
+        const int i = byRatio[l];
+        fill[l]     = min(b[i],(maxW-fillW)/w[i]);
+        fillW      += fill[l]*w[i];
+        fillProf   += fill[l]*p[i];
+        if( (fill[l]>0) && (fillProf-f[fillW]>bestVal) ){
+            bestVal = fillProf-f[fillW];
+            bestL   = l;
+            bestW   = fillW;
+        }
+    }
+
     for(int i=0;i<n;i++)
-        x[f[i]] = xcpy[i];
-    delete[] xcpy;
+        newCut[i] = 0;
+    rHnd = 0;
+    if(bestL>=0){                               //the greedy fill is the best
+        for(int l=0;l<=bestL;l++)
+            newCut[byRatio[l]] = fill[l];
+        rHnd = f[bestW];
+    }else if(bestPatt>=0){
+        for(int i=0;i<n;i++)
+            newCut[i] = pool->mult[bestPatt*n+i];
+        rHnd = f[pool->weight[bestPatt]];
+    }
+    clog<<"Heuristic pricing: best prof-rHnd="<<bestVal<<(bestL>=0?" (greedy)":" (pool)")
+        <<endl;
+    return bestVal;
 }
 
-int*    order     = NULL;
-//when used with std::sort, it will sort in descendent order using comp below
-bool myComp (int i,int j) { return (w[i]/(1+bst_xbase[i])>w[j]/(1+bst_xbase[j]));}
-
 }//namespace
 
-//The linux kernel style allows function-like macros in a do-while that defines a block
-//It also states: "macros resembling functions may be named in lower case"
-#define setOrdre()                    \
-  do{                                 \
-      if(order==NULL)                 \
-          order = new int[n];         \
-      for(int i=0;i<n;i++)            \
-          order[i] = i;               \
-      sort(order, order+n, myComp);   \
-  }while(0);                           
-#define generalInterShuffle(tStar, query_bs,ydirect,newCut,rHnd)            \
-  do{                                                                       \
-    setOrdre();                                                             \
-    reshuffle(ydirect,order);                                               \
-    reshuffle(query_bs,order);                                              \
-    reshuffle(w,order);                                                     \
-    reshuffle(b,order);                                                     \
-    tStar = generalInter(query_bs,ydirect,newCut,rHnd);                     \
-    reshuffleinv(ydirect,order);                                            \
-    reshuffleinv(query_bs,order);                                           \
-    reshuffleinv(w,order);                                                  \
-    reshuffleinv(b,order);                                                  \
-    reshuffleinv(newCut,order);                                             \
-  }while(0);
-
 /*---------------------------------------------------------------------------------------+
 |                                                                                        |
 |                        Functions that call intersection/separation                     |
@@ -485,7 +1443,7 @@ bool myComp (int i,int j) { return (w[i]/(1+bst_xbase[i])>w[j]/(1+bst_xbase[j]))
 
 //The linux kernel style allows function-like macros in a do-while that defines a block
 //It also states: "macros resembling functions may be named in lower case"
-#define clogPrintQueryPnt(p)                                 \
+#define clogPrintQueryPnt(n,p)                               \
   do{                                                        \
     clog<<"query point (curr opt sol, an ub)"<<":";          \
     int printedVals = 0;                                     \
@@ -505,43 +1463,98 @@ bool myComp (int i,int j) { return (w[i]/(1+bst_xbase[i])>w[j]/(1+bst_xbase[j]))
     clog<<endl;                                              \
   }while(0);
 
-bool sepClassicalCalcBounds(double *p, double * newCut, double&rHnd)
+void initSubprobs(cspInstance& inst)
+{
+    inst.bst_xbase     = NULL;
+    inst.bst_xbase_val = 0;
+    inst.xbase         = NULL;
+    inst.query_bs      = NULL;
+    inst.ydirect       = NULL;
+    inst.items         = NULL;
+    inst.dp            = NULL;
+    inst.dpThreads     = 1;
+    inst.dpLayerCells  = 0;
+    inst.cost          = costModelByName("ml1");
+    inst.pool          = NULL;
+    inst.heurPeriod    = 0;
+    inst.queryNonZeros = 0;
+}
+void freeSubprobs(cspInstance& inst)
+{
+    delete[] inst.bst_xbase;
+    delete[] inst.xbase;
+    delete[] inst.query_bs;
+    delete[] inst.ydirect;
+    freeItemTable(inst.items);
+    freeWorkspace(inst.dp);
+    freePricingPool(inst.pool);
+    initSubprobs(inst);
+}
+
+bool sepClassicalCalcBounds(cspInstance& inst, double *p, double * newCut, double&rHnd,
+                            cutPlanesCtx& ctx)
 {
 #ifndef NDEBUG
-    clogPrintQueryPnt(p);
+    clogPrintQueryPnt(inst.n,p);
 #endif
-    double prof_min_rHnd = extendedKnapskDP(p,newCut,rHnd);
+    //the heuristics first, but the exact DP at one call out of heurPeriod
+    pricingPool* pool = inst.pool;
+    if(inst.heurPeriod>0){
+        if(pool==NULL)
+            pool = inst.pool = newPricingPool(inst.n);
+        if( (pool->calls++%inst.heurPeriod!=0) &&
+            (heuristicPricing(inst,p,newCut,rHnd)>EPSILON) )
+            return true;                        //no new Lagrangian bound: the last
+                                                //one stays in ctx.lowerBound
+    }
+    double prof_min_rHnd = extendedKnapskDP(inst,p,newCut,rHnd);
     clog<<"prof-rHnd of classical DP knapsack="<<prof_min_rHnd<<endl;
+    if(pool!=NULL){
+        int bstWeight = 0;
+        for(int i=0;i<inst.n;i++)
+            bstWeight += (int)newCut[i]*inst.w[i];
+        poolDpPatterns(pool,getWorkspace(inst),(int)inst.extC,bstWeight);
+#ifndef NDEBUG
+        checkPoolWeights(pool,inst.w);
+#endif
+    }
 
     //Lagrangian bound for (multiple len) csp
     double minRedCost = -prof_min_rHnd; 
-    ::lowerBound = upperBound/(1-minRedCost*1.0/MIN_PATT_COST);
-    //MIN_PATT_COST is the minimum non-zero pattern cost (1 for std cut stock)
+    ctx.lowerBound = ctx.upperBound/(1-minRedCost*1.0/inst.cost->minPattCost);
+    //minPattCost is the minimum non-zero pattern cost (1 for std cut stock)
 
     return(minRedCost<-EPSILON);             //separation successful
 }
 
 //solve intersection, record results in newCut and rHnd
 //returns true of it is possible to separate point p
-bool sepByIntersectCalcBounds(double *p, double * newCut, double&rHnd,int iter)
+bool sepByIntersectCalcBounds(cspInstance& inst, double *p, double * newCut,
+                              double&rHnd, int iter, cutPlanesCtx& ctx)
 {
+    const int n = inst.n;
+    const int*b = inst.b;
 #ifndef NDEBUG
-    clogPrintQueryPnt(p);
+    clogPrintQueryPnt(n,p);
 #endif
-    static double* query_bs  = new double[n];             //query xbase
-    static double* ydirect   = new double[n];             //ydirection
-    static double* xbase     = new double[n];
-    if(bst_xbase==NULL){
-        bst_xbase   = new double[n];
+    if(inst.bst_xbase==NULL){
+        inst.query_bs  = new double[n];                   //query xbase
+        inst.ydirect   = new double[n];                   //ydirection
+        inst.xbase     = new double[n];
+        inst.bst_xbase = new double[n];
         for(int i=0;i<n;i++)
-            bst_xbase[i] = 0;
+            inst.bst_xbase[i] = 0;
+        inst.items     = newItemTable(n);
     }
+    double* query_bs  = inst.query_bs;
+    double* ydirect   = inst.ydirect;
+    double* bst_xbase = inst.bst_xbase;
     
     //seems faster that putting the conditions (iter%12...) before the loop
     for(int i=0;i<n;i++){
         query_bs[i] = bst_xbase[i]; 
         if(iter%12>=3)   
-            query_bs[i]=TRUNC_DOWN(bst_xbase[i]*0.5);
+            query_bs[i]=truncDown(inst.cost,bst_xbase[i]*0.5);
         if(iter%12>=6)
             query_bs[i] = 0;
         ydirect[i] = p[i] - query_bs[i];
@@ -549,38 +1562,45 @@ bool sepByIntersectCalcBounds(double *p, double * newCut, double&rHnd,int iter)
     }
     //clog<<endl;
 
-    double tStar;
     //Main call to intersection sub-problem after first well shuffling 
-    generalInterShuffle(tStar, query_bs,ydirect,newCut,rHnd);
+    itemTable* it = inst.items;
+    if(it->stale)
+        sortItems(it,inst);
+    loadItems(it,inst,query_bs,ydirect);
+    double tStar = generalInter(inst,it,rHnd);
+    for(int i=0;i<n;i++)
+        newCut[i] = 0;
+    for(int k=0;k<it->n;k++)
+        newCut[it->id[k]] = it->cut[k];
 
 
     //Calculate current lower bound, and base of best objective value
-    ::lowerBound = 0;
+    double* xbase = inst.xbase;
+    ctx.lowerBound = 0;
     double xbase_val = 0;
     for(int i=0;i<n;i++){
-        xbase[i]      = query_bs[i]+tStar*ydirect[i];
-        ::lowerBound += xbase[i] * b[i];
-        xbase[i]      = TRUNC_DOWN(xbase[i]);
-        xbase_val    += xbase[i] * b[i];
+        xbase[i]        = query_bs[i]+tStar*ydirect[i];
+        ctx.lowerBound += xbase[i] * b[i];
+        xbase[i]        = truncDown(inst.cost,xbase[i]);
+        xbase_val      += xbase[i] * b[i];
     }
 
     //update best feasible solution found so far.
-    if(xbase_val>=bst_xbase_val){
+    if(xbase_val>=inst.bst_xbase_val){
         clog<<"update new base of val "<<xbase_val<<"\n";
-        bst_xbase_val = xbase_val;
-        //take xbase as bst_xbase
-        delete[] bst_xbase;
-        bst_xbase     = xbase;
-        xbase         = new double[n];
+        inst.bst_xbase_val = xbase_val;
+        //take xbase as bst_xbase, the old bst_xbase becomes the next xbase buffer
+        inst.bst_xbase     = xbase;
+        inst.xbase         = bst_xbase;
+        inst.items->stale  = 1;
     }
 
 #ifndef NDEBUG
     clog<<"tStar="<<tStar<<"   ";
-    clog<<"lowerBound="<<::lowerBound<<", ";
-    static int nonZeros=0;
+    clog<<"lowerBound="<<ctx.lowerBound<<", ";
     for(int i=0;i<n;i++)
-        nonZeros+=(query_bs[i]>0);
-    clog<<"total nonZeros of all query points till here="<<nonZeros<<endl;
+        inst.queryNonZeros+=(query_bs[i]>0);
+    clog<<"total nonZeros of all query points till here="<<inst.queryNonZeros<<endl;
 #endif
     return (tStar<=1-EPSILON);
 }
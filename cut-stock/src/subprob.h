@@ -7,22 +7,106 @@
 #ifndef SUBPROB_H_INCLUDED
 #define SUBPROB_H_INCLUDED
 
-extern double  C;                    //capacity
-extern double  extC;                 //extended capacity (eg, for elastic vers, or multi-size bp)
-extern int     n;                    //the number of dual variables
-extern int*    b;                    //demands
-extern int*    w;                    //weights
-extern double  lowerBound;           //attention: defined in CuttingPlanesEngine.h
-extern double  upperBound;
+#include "../../src_shared/CuttingPlanesEngine.h"   //for cutPlanesCtx
+#include<cmath>
+
+/*-----------------------+------------------------------------+--------------------------
+                         |  MULTI LEN CUT STOCK DEFINITION    |
+                         +-----------------------------------*/
+//The cost f(X) of a pattern of weight X*C defines the problem. Each model below is a
+//policy type in subprob.cpp; one of them is selected at run time with -costNAME
+//    csp       1. Classical cutting stock : f(X)=1 and maximum extension 1
+//    ml1       2. Multiple Length Cut Stock, f(X)=0.6 or 1, the default
+//    ml2       3. Multiple Length Cut Stock Second Version, f(X)=0.4, 0.6 or 1
+//    elastic2  4. Elastic/Extendable Bin Packing, f(X)=X^2 beyond 1, maximum extension 2
+//    elastic3     the same with f(X)=X^3
+//    vsbp10    5. Variable Sized Bin Packing, f(X)=ceil(10X)/10, maximum extension 2
+//    vsbp2        the same with f(X)=ceil(2X)/2
+//The DPs do not evaluate f: they read the costs of all weights in tables filled once
+typedef struct costModel_{
+    const char* name;
+    double      extMax;           //the maximum extension: patterns weigh at most extMax*C
+    double      minPattCost;      //the minimum non-zero pattern cost (1 for std cut stock)
+    double      truncFact;        //generalInter needs costs multiple of 1/truncFact
+    double      boundsFact;       //the bounds are equal if they round up to the same
+                                  //multiple of 1/boundsFact
+    double    (*f)(double X);
+} costModel;
+
+//the model of this name, NULL if there is none
+const costModel* costModelByName(const char* name);
+
+/*-----------------------+------------------------------------+--------------------------
+                         |        TRUNCATION FUNCTIONS        |
+                         +-----------------------------------*/
+//Below I use the fact that the closest integer to x is floor(x+0.5)
+//The frontpareto is faster when using integer costs corresponding to double
+//costs that are multiples of 1/truncFact (e.g., of 0.2 for truncFact=5)
+inline int truncMlt(const costModel* cm, double x)
+{
+    return (int)floor(x*cm->truncFact+0.5);
+}
+inline double truncNear(const costModel* cm, double x)
+{
+    return floor(x*cm->truncFact+0.5)/cm->truncFact;
+}
+inline double truncDown(const costModel* cm, double x)
+{
+    return floor(x*cm->truncFact)/cm->truncFact;
+}
+
+struct dpWorkspace;                //the memory of the DPs, see subprob.cpp
+struct itemTable;                  //the articles of generalInter, see subprob.cpp
+struct pricingPool;                //the pattern pool of heurPeriod, see subprob.cpp
+
+//An instance and the state of its sub-problems. There are no globals in the sub-problems,
+//so that several instances (each with its cspInstance) can be solved in parallel threads
+typedef struct cspInstance_{
+    double  C;                    //capacity
+    double  extC;                 //extended capacity (eg, for elastic vers, or multi-size bp)
+    int     n;                    //the number of dual variables
+    int*    b;                    //demands
+    int*    w;                    //weights
+    //Below: the state of the sub-problems, see initSubprobs() and freeSubprobs()
+    double* bst_xbase;            //the best feasible solution found so far, truncated
+    double  bst_xbase_val;
+    double* xbase;                //buffers of sepByIntersectCalcBounds
+    double* query_bs;
+    double* ydirect;
+    itemTable* items;             //the articles in the order used by generalInter
+    long    queryNonZeros;        //total nonZeros of all query points, for the debug log
+    dpWorkspace* dp;              //states, reached set, transitions, kept between calls
+    int     dpThreads;            //threads sharing the large passes of generalInter, 1 by
+                                  //default; set it before the first sub-problem
+    long    dpLayerCells;         //>0: extendedKnapskDP keeps the layers of its articles
+                                  //in at most dpLayerCells cells, to start the next call
+                                  //from them; 0 by default, set it before the first call
+    const costModel* cost;        //ml1 by default; set it before the first sub-problem
+    pricingPool* pool;            //the patterns of the pricing heuristics
+    int     heurPeriod;           //>0: sepClassicalCalcBounds tries heuristics first, the
+                                  //exact DP once every heurPeriod calls or when they
+                                  //fail; 0 (default): the exact DP at each call
+} cspInstance;
+
+//empty state of the sub-problems of inst (the buffers are allocated at first use)
+void initSubprobs(cspInstance& inst);
+//release the state of the sub-problems of inst, not its b and w
+void freeSubprobs(cspInstance& inst);
 
 //try to separate point and fill newCut and rHnd, return true if success
-bool sepClassicalCalcBounds(double *point, double * newCut, double&rHnd);
+//it reads ctx.upperBound and sets ctx.lowerBound to the Lagrangian bound of the exact DP;
+//when a pricing heuristic separates point (see heurPeriod), there is no such bound and it
+//leaves ctx.lowerBound unchanged
+bool sepClassicalCalcBounds(cspInstance& inst, double *point, double * newCut,
+                            double&rHnd, cutPlanesCtx& ctx);
 
 //calculates the query points (base and direction) and
 //solves intersection, recording results in newCut and rHnd
 //returns true of it is possible to separate p
 //At some iterations it shoots from zeros, at others from the best base, etc.
-bool sepByIntersectCalcBounds(double *point, double * newCut, double&rHnd, int iter);
+//it sets ctx.lowerBound to the value of the feasible solution found on the way
+bool sepByIntersectCalcBounds(cspInstance& inst, double *point, double * newCut,
+                              double&rHnd, int iter, cutPlanesCtx& ctx);
 
 /*--------------------+------------------------------------------+-----------------------
                       |FUNCTIONS BELOW EXIST IN UNNAMED NAMESPACE|
@@ -32,57 +116,10 @@ bool sepByIntersectCalcBounds(double *point, double * newCut, double&rHnd, int i
 //Return t=min ----------- , over all patterns a where c_a is the ptn cost
 //               y^T a
 //We'll have (x^T+ty^T )a <= c_a for all ptns a
-double generalInter(double *x, double* y, double * newCut, double&rHnd);
+double generalInter(cspInstance& inst, itemTable* it, double&rHnd);
 //solve extended knapsack for separation
 //max p^Ta - c_a
-double extendedKnapskDP(p,newCut,rHnd);
+double extendedKnapskDP(inst,p,newCut,rHnd);
 */
 
-/*-----------------------+------------------------------------+--------------------------
-                         |  MULTI LEN CUT STOCK DEFINITION    |
-                         +-----------------------------------*/
-//1. Classical cutting stock : function f and maximum extension 1
-//#define MIN_PATT_COST 1.0
-//#define EXT_F(X) (((double)X)<=1 ? 1 : INT_MAX)
-//#define EXT_MAX (1)
-//2. Multiple Length Cut Stock, IPOPT is a multiple of 0.2
-#define EQUAL_BOUNDS(X,Y) (ceil(5*X)==ceil(5*Y))
-#define MIN_PATT_COST 0.6
-#define EXT_MAX (1)
-#define EXT_F(X) (((double)X)<=1 ? (((double)X)<=0.7 ? 0.6 : 1 ) : INT_MAX)
-//3. Multiple Length Cut Stock Second Version
-//#define EQUAL_BOUNDS(X,Y) (ceil(5*X)==ceil(5*Y))
-//#define MIN_PATT_COST 0.6
-//#define EXT_MAX (1)
-//#define EXT_F(X) (((double)X)<=1 ?                                         \
-//                  (((double)X)<=0.7? (((double)X)<=0.5 ? 0.4 : 0.6 ) : 1 ) \
-//                  :                                                        \
-//                  INT_MAX   /*infeasible*/                                 \
-//                 )
-
-/* other problems can be tested
-    //4. Elastic/Extendable Bin Packing Quadratic
-    //#define EXT_MAX (2)
-    //#define EXT_F(x) ( ((double)x)<=1 ? 1 : ((double)x)*((double)x) )
-    //#define EXT_F(x) ( ((double)x)<=1 ? 1 : ((double)x)*((double)x)*((double)x) )
-    //5. Variabled Sized Bin Packing
-    //#define EXT_MAX (2)
-    //#define EXT_F(x) ( ceil(10.0*(double)x)/10 )
-    //#define EXT_MAX (2)
-    //#define EXT_F(x) ( ceil(2.0*(double)x)/2 )
-*/
-
-/*-----------------------+------------------------------------+--------------------------
-                         |        TRUNCATION MACROS           |
-                         +-----------------------------------*/
-//Below I use the fact that the closest integer to x is floor(x+0.5)
-#define TRUNC_FACT    5.0
-//The frontpareto is faster when using integer costs corresponding to double 
-//costs that are multiples of 0.2
-#define TRUNC_MLT(x)  ((int)floor((x)*TRUNC_FACT+0.5))
-#define TRUNC(x)      (floor((x)*TRUNC_FACT+0.5)/TRUNC_FACT)
-#define TRUNC_DOWN(x) (floor((x)*TRUNC_FACT)/TRUNC_FACT)
-//#define TRUNC_FACT    4.0     //Fails on hard, better on triplets (rtime, not iters)
-                                //but it is more elegant to take 1/TRUNC_FACT multiple of 0.2
-
 #endif
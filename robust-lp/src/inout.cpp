@@ -10,8 +10,10 @@
 #include <sstream>
 #include <cassert>
 using namespace std;
-void readInstance(char* filename)
+void readInstance(char* filename, rlpInstance& r)
 {
+    int&      n = r.n;
+    int&      m = r.m;
     ifstream inFile (filename);
     if(!inFile.good()){
         cerr<<"I can not read instance from "<<filename<<endl;
@@ -26,64 +28,79 @@ void readInstance(char* filename)
         istringstream in (line);
         switch(lineNo){
             case(0):
-                in>>::n;
+                in>>n;
                 break;
             case(1):
-                in>>::m;
-                ::obj         = new double[::n];
-                ::lb          = new double[::n];
-                ::ub          = new double[::n];
-                ::rows = new double*[::m];
-                for(int i=0;i<(::m);i++)
-                    ::rows[i] = new double[::n+2];
-                for(int i=0;i<(::n);i++){
-                    ::obj[i] = 0;
-                    for(int j=0;j<(::m);j++)
-                        ::rows[j][i] = 0;
+                in>>m;
+                r.obj         = new double[n];
+                r.lb          = new double[n];
+                r.ub          = new double[n];
+                r.rows = new double*[m];
+                for(int i=0;i<m;i++)
+                    r.rows[i] = new double[n+2];
+                for(int i=0;i<n;i++){
+                    r.obj[i] = 0;
+                    for(int j=0;j<m;j++)
+                        r.rows[j][i] = 0;
                 }
                 break;
             case 2:
                 in>>dummy;
                 if(dummy=="LBVARS")
-                    in>>lb[0];
+                    in>>r.lb[0];
                 else
-                    istringstream(dummy)>>lb[0];
-                for(int i=1;i<(::n);i++)
-                    in >> lb[i];
+                    istringstream(dummy)>>r.lb[0];
+                for(int i=1;i<n;i++)
+                    in >> r.lb[i];
                 break;
             case 3:
                 in>>dummy;
                 if(dummy=="UBVARS")
-                    in>>ub[0];
+                    in>>r.ub[0];
                 else
-                    istringstream(dummy)>>ub[0];
-                for(int i=1;i<(::n);i++)
-                    in >> ub[i];
+                    istringstream(dummy)>>r.ub[0];
+                for(int i=1;i<n;i++)
+                    in >> r.ub[i];
                 break;
             case(4):
                 in>>dummy;
                 while(in>>var_id){
                     in>>coef;
-                    obj[var_id] = coef;
-                    assert(var_id<(::n));
+                    r.obj[var_id] = coef;
+                    assert(var_id<n);
                 }
                 break;
             default:
                 in>>dummy;
-                in>>rows[lineNo-5][::n];          //1st in line: right hand side
+                in>>r.rows[lineNo-5][n];          //1st in line: right hand side
                 in>>dummy;
-                rows[lineNo-5][::n+1] = 0;        //0  means ...==rHand
+                r.rows[lineNo-5][n+1] = 0;        //0  means ...==rHand
                 if((dummy=="G")||(dummy=="<="))
-                    rows[lineNo-5][::n+1] = -1;   //-1  means ...>=rhand
+                    r.rows[lineNo-5][n+1] = -1;   //-1  means ...>=rhand
                 if((dummy=="L")||(dummy==">="))
-                    rows[lineNo-5][::n+1] = 1;    //1 means ...<=rhand
+                    r.rows[lineNo-5][n+1] = 1;    //1 means ...<=rhand
                 
                 while(in>>var_id){
                     in>>coef;
-                    rows[lineNo-5][var_id] = coef;
+                    r.rows[lineNo-5][var_id] = coef;
                 }
                 break;
         }
         lineNo++;
     }
+
+    //record the non-zeros of each row, so that robust cuts can be built in O(nnz)
+    r.rowNz    = new int*[m];
+    r.rowNzLen = new int[m];
+    for(int i=0;i<m;i++){
+        r.rowNzLen[i] = 0;
+        for(int j=0;j<n;j++)
+            if(r.rows[i][j]!=0)
+                r.rowNzLen[i]++;
+        r.rowNz[i]    = new int[r.rowNzLen[i]];
+        r.rowNzLen[i] = 0;
+        for(int j=0;j<n;j++)
+            if(r.rows[i][j]!=0)
+                r.rowNz[i][r.rowNzLen[i]++] = j;
+    }
 }
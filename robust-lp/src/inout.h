@@ -2,11 +2,9 @@
 
 #ifndef INOUT_H
 #define INOUT_H
-extern int n;       //number of variables
-extern int m;       //number of initial rows
-extern double*  obj;
-extern double*  lb;
-extern double*  ub;
-extern double** rows;
-void readInstance(char* filename);
+#include "subprob.h"         //for rlpInstance
+
+//Reads into r.n, m, obj, lb, ub, rows and rowNz[i][0..rowNzLen[i]-1]: the increasing
+//positions of the non-zero coefficients in rows[i]. Exits if error
+void readInstance(char* filename, rlpInstance& r);
 #endif
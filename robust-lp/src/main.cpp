@@ -4,6 +4,7 @@
 
 #include "inout.h"
 #include "subprob.h"
+#include "../../src_shared/general.h"
 #include "../../src_shared/CuttingPlanesEngine.h"
 #include <iostream>
 #include <iomanip>
@@ -16,20 +17,9 @@ using namespace std;
 
 
 /*----------------------   Project-wide Global Variables     ---------------------*/
-int      n;                       //number of variables
-int      m;                       //number of initial rows
-int      gamma=10;                //uncertainty budget
-double*  obj;                     //objective function coefficients
-double** rows;                    //rows with n+2 positions: the coefficients +
-                                  //rows[...][n] = rHand, rows[...][n+1]=EQUALITY,LESS_THAN_EQ
-                                  //where EQUALITY and LESS_THAN_EQ are defined in subprob.h
-                                  //They indicate if we have an equality or <= cut
-
-double*  lb;                      //lower and upper bounds for each variabl
-double*  ub;
-double*  xbase;                   //xbase the x from the paper,
-double*  d;                       //used to solve proj_subprob(x->d)
-
+//The instance (rows, bounds, xbase, etc.) is in an rlpInstance (see subprob.h) given to
+//the sub-problems by the engine context; the globals below are options or results
+int      gamma=10;                //uncertainty budget, copied to rlpInstance.gamma
 int      seed;                    //random seed
 int      iters;                   //iters and tmCPlanes will be filled by cutPlanes.runCutPlanes(...)
 bool     runStd;                  //true if we run the standard algorithm, false otherwise
@@ -40,58 +30,71 @@ bool     latex_print_only = false;
 
 /*------------------- Iteration count and time information  ---------------------*/
 double   tmCPlanes;
-double   tmSort     = 0;
-int      iterLowGap = -1;         //iteration when ub<=bstLowerBound*1.2
-double   tmLowGap   = -1;         //tm for above
 double   nominalObj, finalObj;
 char*    startsol = NULL;
-int      total_multi_cuts = 0;
-bool     multi_cuts_per_round;
+bool     multi_cuts_per_round;    //copied to rlpInstance.multi_cuts_per_round
+int      cutPoolAge = 0;          //if >0, purge cuts non-binding for more than cutPoolAge iters
+bool     warmStart  = false;      //re-solve with the dual simplex from the last basis
+bool     pipelined  = false;      //separate the previous primals during each re-solve
+char*    statsFile  = NULL;       //per-iteration statistics, JSON lines if it ends in .jsonl
 
 /*-------------------        Sub-problem solving routines  ---------------------*/
 
 //return rHand - newRow^T x. The cut that will be added is: newRow^T x <= rHand
-double sub_problem_single_cut (const int nrVars, double*x, double * newRow,double&newRHand)
+//The cuts are written in sparse form, so that the engine builds them in O(nnz)
+double sub_problem (const int nrVars, double*x, sparseCut& newRow, int it, double tm,
+                            sparseCut* newRows, int& newMore, int maxNewMore,
+                            cutPlanesCtx& ctx)
 {
-    for(int i=0;i<(::n);i++)
-        if(x[i]<lb[i])        //again numerical problems should be eliminated
-            x[i]=lb[i];
+    rlpInstance& r = *(rlpInstance*)ctx.userData;
+    for(int i=0;i<r.n;i++)
+        if(x[i]<r.lb[i])      //again numerical problems should be eliminated
+            x[i]=r.lb[i];
 
-    if(runStd)
-        return separation(x,newRow,newRHand);
-    else
-        return projection(x,newRow,newRHand);
-}
-
-//return rHand - newRow^T x. The cut that will be added is: newRow^T x <= rHand
-double sub_problem (const int nrVars, double*x, double * newRow, double&newRHand, 
-                            int it, double tm,
-                            double**newRows, double*newRHands, int& newMore, int maxNewMore )
-{
-    if(!multi_cuts_per_round){
+    if(!r.multi_cuts_per_round){
         newMore = 0;
-        total_multi_cuts++;
-        return sub_problem_single_cut(nrVars,x,newRow,newRHand);
+        r.total_multi_cuts++;
+        if(runStd)
+            return separation(r,x,newRow);
+        else
+            return projection(r,x,newRow,ctx);
     }
 
-    for(int i=0;i<(::n);i++)
-        if(x[i]<lb[i])        //again numerical problems should be eliminated
-            x[i]=lb[i];
-
     double ret_val ;
     if(runStd)
-        ret_val = separation_multi(x,newRow,newRHand, newRows, newRHands, newMore, multi_cuts_limited);
+        ret_val = separation_multi(r,x,newRow, newRows, newMore, multi_cuts_limited);
     else
-        ret_val = projection_multi(x,newRow,newRHand, newRows, newRHands, newMore, multi_cuts_limited);
+        ret_val = projection_multi(r,x,newRow, newRows, newMore, ctx, multi_cuts_limited);
 
-    total_multi_cuts+=(newMore+1);
-    if(total_multi_cuts>=10000){
-        clog<<"\nI switch to a mono-cut sub-problem because I already have too many cuts: "<<total_multi_cuts <<endl;
-        multi_cuts_per_round = false;
+    r.total_multi_cuts+=(newMore+1);
+    if(r.total_multi_cuts>=10000){
+        clog<<"\nI switch to a mono-cut sub-problem because I already have too many cuts: "
+            <<r.total_multi_cuts <<endl;
+        r.multi_cuts_per_round = false;
     }
     return ret_val;
 }
 
+//Add the nominal rows (only their non-zeros), rrows can be r.rows or a modified copy
+void addNominalRows(rlpInstance& r, CuttingPlanesEngine& cutPlanes, double** rrows)
+{
+    sparseCut row;
+    row.idx = new int[r.n];
+    row.val = new double[r.n];
+    for(int i=0; i < r.m; i++){
+        row.nnz   = r.rowNzLen[i];
+        row.rHand = rrows[i][r.n];
+        row.sense = (int)rrows[i][r.n+1];
+        for(int k=0;k<r.rowNzLen[i];k++){
+            row.idx[k] = r.rowNz[i][k];
+            row.val[k] = rrows[i][r.rowNz[i][k]];
+        }
+        cutPlanes.modelAddCut(row);
+    }
+    delete[] row.idx;
+    delete[] row.val;
+}
+
 void checkAllParams(int& argc, char** argv)
 {
     int verbose = 0;
@@ -127,10 +130,30 @@ void checkAllParams(int& argc, char** argv)
             clog<<"Input start sol: "<<startsol<<endl;
             argc--;
         }
+        if(argv[argc-1][1]=='p') {
+            cutPoolAge = atoi(argv[argc-1]+2);
+            clog<<"Cuts with zero duals for more than "<<cutPoolAge<<" iters go to a pool"<<endl;
+            argc--;
+        }
         if(argv[argc-1][1]=='t') {
             latex_print_only = true;
             argc--;
         }
+        if(argv[argc-1][1]=='a') {
+            pipelined = true;
+            clog<<"The separation of the previous primals overlaps each re-solve"<<endl;
+            argc--;
+        }
+        if(argv[argc-1][1]=='w') {
+            warmStart = true;
+            clog<<"Re-solves use the dual simplex from the last basis"<<endl;
+            argc--;
+        }
+        if(argv[argc-1][1]=='s') {
+            statsFile = argv[argc-1]+2;
+            clog<<"Statistics of each iteration written to "<<statsFile<<endl;
+            argc--;
+        }
         if(argc_start==argc){
             cerr<<"Failed parsing option '"<<argv[argc-1]
                 <<"'. Run ./main to see all options."<<endl;
@@ -143,42 +166,49 @@ void checkAllParams(int& argc, char** argv)
         cerr<<"\nUsage: ./main method(std, prj or wEXTENSION) instance "
               "[-m[ultiple_cuts_per_round]] [-l[limited multi cuts] "
               "[-v[erbose]] [-gGAMMA, eg -g50] [-r[nd]] [-iINPUTSTARTSOL] [-t[abularLatexOnly]]\n"
+              "           [-pAGE, eg -p20] [-w[armStart]] [-a[sync]] [-sSTATSFILE]\n"
               "           std=standard meth, prj=projective meth, "
               "w=write feasib sol to instance.EXTENSION\n"
               "           Use -v to enable printing log messages\n"
               "           Use -t to print only latex data\n"
               "           Use -r[nd] to randomize algo \n"
+              "           Use -pAGE to purge cuts with zero duals during AGE iters\n"
+              "           Use -w to re-solve by dual simplex from the last basis\n"
+              "           Use -a to separate the previous primals during each re-solve\n"
+              "           Use -sFILE to write the statistics of each iteration (CSV, or\n"
+              "                      JSON lines if FILE ends in .jsonl)\n"
               "           Best methods/switches: -m for prj and -l for std\n";
         exit(EXIT_FAILURE);
     }
 }
 
-void buildFeasibSol(char* outfile)
+void buildFeasibSol(rlpInstance& r, char* outfile)
 {
-    double** rrows = new double*[::m];
-    for(int i=0;i<(::m);i++){
-        rrows[i] = new double[::n+2];
-        for(int j=0;j<(::n)+2;j++)
-            rrows[i][j] = rows[i][j];
+    const int n = r.n;
+    double** rrows = new double*[r.m];
+    for(int i=0;i<r.m;i++){
+        rrows[i] = new double[n+2];
+        for(int j=0;j<n+2;j++)
+            rrows[i][j] = r.rows[i][j];
     }
-    for(int i=0;i<(::m);i++)
-         if(rows[i][n+1]==LESS_THAN_EQ){
+    for(int i=0;i<r.m;i++)
+         if(r.rows[i][n+1]==LESS_THAN_EQ){
              for(int j=0;j<n;j++)
                     rrows[i][j]+=0.02*absVal(rrows[i][j]);
              rrows[i][n]-=0.00150;
          }
-    CuttingPlanesEngine cutPlanes(::n,sub_problem_single_cut); 
-    for(int i=0; i < (::n); i++){
-        assert(lb[i]<=ub[i]);
-        cutPlanes.setVarBounds(i,lb[i],ub[i]);
+    CuttingPlanesEngine cutPlanes(n,sub_problem,0); 
+    cutPlanes.setSeparatorData(&r);
+    for(int i=0; i < n; i++){
+        assert(r.lb[i]<=r.ub[i]);
+        cutPlanes.setVarBounds(i,r.lb[i],r.ub[i]);
     }
-    for(int i=0; i < (::m); i++){
-        cutPlanes.modelAddWithSense(rrows[i],rrows[i][::n],rrows[i][::n+1]);
+    addNominalRows(r,cutPlanes,rrows);
+    for(int i=0; i < r.m; i++)
         delete[] rrows[i];
-    }
     delete[] rrows;
-    //for(int i=0;i<n;i++) obj[i]=rand()%20;
-    cutPlanes.setObjCoefsMinimize(obj);
+    //for(int i=0;i<n;i++) r.obj[i]=rand()%20;
+    cutPlanes.setObjCoefsMinimize(r.obj);
 
     nominalObj = cutPlanes.solve();
     if(nominalObj!=INT_MAX)
@@ -188,14 +218,14 @@ void buildFeasibSol(char* outfile)
         exit(EXIT_FAILURE);
     }
 
-    xbase = new double[n]; 
-    cutPlanes.getPrimals(xbase); 
+    r.xbase = new double[n]; 
+    cutPlanes.getPrimals(r.xbase); 
     cout<<"Loaded solution to xbase.\n";
     if(outfile!=NULL){
         cout<<" Writing it to "<<outfile<<"  ..   ";
         ofstream out(outfile);
         for(int i=0;i<n;i++)
-            out<<setprecision(21)<<xbase[i]<<" ";
+            out<<setprecision(21)<<r.xbase[i]<<" ";
         out.close();
         cout<<"Done"<<endl;
     }
@@ -208,7 +238,14 @@ int main(int argc, char** argv)
     runStd = 1;
     if(strcmp(argv[1],"std"))                             //if first arg different from std
         runStd = 0;                                       //run projective
-    readInstance(argv[2]);
+    rlpInstance r;
+    initSubprobs(r);
+    r.gamma                = ::gamma;
+    r.multi_cuts_per_round = multi_cuts_per_round;
+    r.xbase                = NULL;
+    r.d                    = NULL;
+    readInstance(argv[2],r);
+    const int n = r.n;
 
     /*-----------          GENERATE FEASIBLE SOLUTION MODE        -----------*/
     if(argv[1][0]=='w'){
@@ -219,25 +256,44 @@ int main(int argc, char** argv)
             strcat(outsol,"start");
         else 
             strcat(outsol,argv[1]+1);
-        buildFeasibSol(outsol);
+        buildFeasibSol(r,outsol);
         return EXIT_SUCCESS;
     }
 
     /*-----------        INIT CUT PLANES OBJ and CONSTRAINTS       -----------*/
-    CuttingPlanesEngine cutPlanes(::n,sub_problem,m*2); //m*2=maximum m*2 cuts per iter
+    CuttingPlanesEngine cutPlanes(n,sub_problem,r.m*2); //m*2=maximum m*2 cuts per iter
                                                         //two cuts per row maxi,
                                                         //useful for projection
+    cutPlanes.setSeparatorData(&r);
     //cutPlanes.activateLog();
-    for(int i=0; i < (::n); i++){
-        assert(lb[i]<=ub[i]);
-        cutPlanes.setVarBounds(i,lb[i],ub[i]);
+    for(int i=0; i < n; i++){
+        assert(r.lb[i]<=r.ub[i]);
+        cutPlanes.setVarBounds(i,r.lb[i],r.ub[i]);
     }
     if(seed>0)
-        cutPlanes.setObjCoefsMinRandomizedSolving(obj,seed);
+        cutPlanes.setObjCoefsMinRandomizedSolving(r.obj,seed);
     else
-        cutPlanes.setObjCoefsMinimize(obj);
-    for(int i=0; i < (::m); i++)
-        cutPlanes.modelAddWithSense(rows[i],rows[i][::n],rows[i][::n+1]);
+        cutPlanes.setObjCoefsMinimize(r.obj);
+    addNominalRows(r,cutPlanes,r.rows);
+    if(cutPoolAge>0)
+        cutPlanes.activateCutPool(cutPoolAge);
+    if(warmStart)
+        cutPlanes.activateWarmStart();
+    if(pipelined)
+        cutPlanes.activatePipelining();
+    ofstream statsOut;
+    if(statsFile!=NULL){
+        statsOut.open(statsFile);
+        if(!statsOut.good()){
+            cerr<<"Can not open statistics file '"<<statsFile<<"'"<<endl;
+            exit(EXIT_FAILURE);
+        }
+        int len = strlen(statsFile);
+        if((len>=6)&&(!strcmp(statsFile+len-6,".jsonl")))
+            cutPlanes.writeIterStats(statsOut, ITER_STATS_JSONL);
+        else
+            cutPlanes.writeIterStats(statsOut, ITER_STATS_CSV);
+    }
 
     /*-----------------   INPUT SOL FOR PROJECTIVE METHOD   ------------------*/
     if(!runStd){
@@ -248,24 +304,25 @@ int main(int argc, char** argv)
         }
         ifstream in(startsol);
         if(in.good()){
-            xbase = new double[::n];
-            d     = new double[::n];
-            for(int i=0;i<(::n);i++)
-                in>>xbase[i];
+            r.xbase = new double[n];
+            r.d     = new double[n];
+            for(int i=0;i<n;i++)
+                in>>r.xbase[i];
             clog<<"I loaded start solution from "<<startsol<<endl;
         }else{
-            d     = new double[::n];
+            r.d     = new double[n];
             cerr<<"Can not open input feasible solution '"<<startsol
                 <<"'. Use 'wEXTENSION' instead of "<<argv[1]<<" to generate a "
                   "solution and write it to "<<argv[2]<<".EXTENSION\n"
                 <<"I will try to generate a solution now!"<<endl;
-            buildFeasibSol(NULL);
+            buildFeasibSol(r,NULL);
         }
     }
 
     /*-----------------           RUN CUT PLANES           ------------------*/
     nominalObj = cutPlanes.solve();
     //int cuts_start = cutPlanes.getNbCuts();
+    r.startCpuTime = getCPUTime();
     if(cutPlanes.runCutPlanes(100000, 150000, iters, tmCPlanes)==EXIT_FAILURE){
         finalObj = cutPlanes.getObjVal();
         if(!latex_print_only){
@@ -294,14 +351,21 @@ int main(int argc, char** argv)
 
     cout<<"Ratio (robustobj-nominalObj)/nominalObj:";
     cout<<setprecision(4)<<setw(7)<<(finalObj-nominalObj)/absVal(nominalObj)*100;
-    if(iterLowGap!=-1)
-        cout<<" LOWGAP_ITERS"<<setw(9)<<iterLowGap<<" LOWGAP_TIME "<<setw(9)<<tmLowGap;
+    if(r.iterLowGap!=-1)
+        cout<<" LOWGAP_ITERS"<<setw(9)<<r.iterLowGap<<" LOWGAP_TIME "<<setw(9)<<r.tmLowGap;
     cout<<" ITERS"<<setw(5)<<iters<<" TIME"<<setw(9)<<tmCPlanes;
     //if(iterLowGap!=-1)
     //    cout<<"P"<<setw(6)<<setprecision(3)<<100.0*tmLowGap/tmCPlanes;
-    if(total_multi_cuts>0)
-        cout<<" MULTICUTS "<<setw(5)<<total_multi_cuts;   //or cutPlanes.getNbCuts()-cuts_start;
-    //cout<<"| "<<setw(6)<<setprecision(3)<<100.0*tmSort/tmCPlanes;
+    if(r.total_multi_cuts>0)
+        cout<<" MULTICUTS "<<setw(5)<<r.total_multi_cuts;   //or cutPlanes.getNbCuts()-cuts_start;
+    if(cutPoolAge>0)
+        cout<<" POOL "<<setw(5)<<cutPlanes.getCutPoolSize()<<" PURGES "<<setw(6)
+            <<cutPlanes.getNrPurgedCuts()<<" REACTIV "<<setw(6)<<cutPlanes.getNrReactivatedCuts();
+    cout<<" PIVOTS/ITER "<<setw(7)<<setprecision(4)<<(double)cutPlanes.getNrSimplexIters()/max(iters,1)
+        <<" SOLVE_TIME "<<setw(9)<<cutPlanes.getTmOnlySolve();
+    if(pipelined)
+        cout<<" STALE_CUTS "<<setw(6)<<cutPlanes.getNrStaleCuts();
+    //cout<<"| "<<setw(6)<<setprecision(3)<<100.0*r.tmSort/tmCPlanes;
     cout<<endl;
     //fast exit
     exit(EXIT_SUCCESS);
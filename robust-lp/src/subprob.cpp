@@ -13,62 +13,70 @@ using namespace std;
 #define EPSILON    1.0E-6
 #define DEV_NOM    0.01      //it can deviate 1% of the nominal value
 
-double*  slack = NULL;           
-double*  maxDev  = NULL;    //maximum deviation in a robust cut using gamma terms
-int*     order = NULL;
-double*  profits;           //sortProfits below sorts putting max profits first
-double*  toCut;
-int      iter = 0;
-extern double tmSort;
-extern int total_multi_cuts;
-
-//functions and variables defined outside
+//functions defined outside
 extern "C"{ double getCPUTime();};
-extern double lowerBound;
 
 /*-----------------------+------------------------------------+--------------------------
                          |VARIOUS GENERAL ROUTINES (eg., sort)|
                          +-----------------------------------*/
-bool comparator (int i,int j) { return (profits[i]>profits[j]); }
+void initSubprobs(rlpInstance& r)
+{
+    r.slack            = NULL;
+    r.maxDev           = NULL;
+    r.devIdx           = NULL;
+    r.deviates         = NULL;
+    r.profits          = NULL;
+    r.toCut            = NULL;
+    r.iter             = 0;
+    r.bestUb           = INT_MAX;
+    r.startCpuTime     = getCPUTime();
+    r.tmSort           = 0;
+    r.iterLowGap       = -1;
+    r.tmLowGap         = -1;
+    r.total_multi_cuts = 0;
+    r.multi_cuts_per_round = false;
+}
+void freeSubprobs(rlpInstance& r)
+{
+    delete[] r.slack;
+    delete[] r.maxDev;
+    delete[] r.devIdx;
+    delete[] r.deviates;
+    delete[] r.profits;
+    delete[] r.toCut;
+    initSubprobs(r);
+}
+
+//profits are shared by tStarForRow and calcMaxDeviations, allocate them once
+#define allocProfits(r)                                                       \
+  do{                                                                         \
+    if(r.profits==NULL)                                                       \
+        r.profits = new double[r.n];                                          \
+  }while(false);
+
 struct classcomp {
+  const double* profits;
   bool operator() (const int& lhs, const int& rhs) const
   {return profits[lhs]>profits[rhs];}
 };
-void sortProfits(int* order)
+//Put in bestGamma the (at most) gamma positions j of highest positive profit
+//profits[j]=|rows[i][j]*pnt[j]|. Only the non-zeros of row i are scanned.
+void sortProfitsOfRow(rlpInstance& r, int i, double* pnt,
+                      multiset<int,classcomp>& bestGamma)
 {
     double tmStart = getCPUTime();
-    multiset<int,classcomp> bestGamma;
     int added = 0;
-    for(int i=0;i<n;i++)
-        if(profits[i]>0){
-            bestGamma.insert(i);
+    for(int k=0;k<r.rowNzLen[i];k++){
+        int j        = r.rowNz[i][k];
+        r.profits[j] = absVal(r.rows[i][j]*pnt[j]);
+        if(r.profits[j]>0){
+            bestGamma.insert(j);
             added++;
-            if(added>gamma)
+            if(added>r.gamma)
                 bestGamma.erase(--bestGamma.end());
         }
-    int ii = 0;
-    int* selected = new int[n];
-    for(int i=0;i<n;i++)
-        selected[i] = 0;
-    for (multiset<int>::iterator it=bestGamma.begin(); it!=bestGamma.end(); ++it){
-        assert(ii>=0);
-        assert(ii<n);
-        order[ii] = *it;
-        selected[*it] = 1;
-        ii++;
-    }
-    int jj= 0;
-    for(;ii<n;ii++){
-        while(selected[jj])
-            jj++;
-        order[ii] = jj;
-        jj++;
     }
-    delete[] selected;
-    //for(int i=0;i<(::n);i++)
-    //    order[i]=i;
-    //std::sort(order, order+::n,comparator);                                
-    tmSort+= (getCPUTime()-tmStart);
+    r.tmSort+= (getCPUTime()-tmStart);
 }
 
 double absVal(double z){
@@ -76,13 +84,71 @@ double absVal(double z){
         return z;
     return -z;
 }
-double scalprod(double *x, double* y)
+double scalprod(int n, double *x, double* y)
 {
     double prod=0;
-    for(int i=0;i<(::n);i++)
+    for(int i=0;i<n;i++)
         prod += x[i] * y[i];
     return prod;
 }
+double scalprod(const sparseCut& cut, double* y)
+{
+    double prod=0;
+    for(int k=0;k<cut.nnz;k++)
+        prod += cut.val[k] * y[cut.idx[k]];
+    return prod;
+}
+
+//Write in cut the robust version of row i with regards to pnt: the (at most) gamma
+//coefficients of highest |rows[i][j]*pnt[j]| deviate by DEV_NOM. If fewer than gamma
+//profits are positive, the remaining deviations go to the first other positions. The
+//sign of deviation j is that of rows[signRow][j]*pnt[j], with signRow=i in general.
+void robustCutOfRow(rlpInstance& r, int i, int signRow, double* pnt, sparseCut& cut)
+{
+    const int n        = r.n;
+    double**  rows     = r.rows;
+    int**     rowNz    = r.rowNz;
+    int*      rowNzLen = r.rowNzLen;
+    if(r.devIdx==NULL){
+        r.devIdx   = new int[r.gamma];
+        r.deviates = new char[n];
+        for(int j=0;j<n;j++)
+            r.deviates[j] = 0;
+    }
+    int*  devIdx   = r.devIdx;
+    char* deviates = r.deviates;
+    classcomp comp;
+    comp.profits = r.profits;
+    multiset<int,classcomp> bestGamma(comp);
+    sortProfitsOfRow(r,i,pnt,bestGamma);
+    int nrDev = 0;
+    for (multiset<int>::iterator it=bestGamma.begin(); it!=bestGamma.end(); ++it){
+        devIdx[nrDev++] = *it;
+        deviates[*it]   = 1;
+    }
+    for(int j=0;(nrDev<r.gamma)&&(j<n);j++)
+        if(!deviates[j]){
+            devIdx[nrDev++] = j;
+            deviates[j]     = 1;
+        }
+
+    cut.nnz   = rowNzLen[i];
+    cut.rHand = rows[i][n];
+    cut.sense = 1;                                            //cut of the form <=
+    for(int k=0;k<rowNzLen[i];k++){
+        int jj      = rowNz[i][k];
+        cut.idx[k]  = jj;
+        cut.val[k]  = rows[i][jj];
+        if(deviates[jj]){
+            if(rows[signRow][jj]*pnt[jj]>=0)
+                cut.val[k] = rows[i][jj] * (1+DEV_NOM);
+            else
+                cut.val[k] = rows[i][jj] * (1-DEV_NOM);
+        }
+    }
+    for(int j=0;j<nrDev;j++)
+        deviates[devIdx[j]] = 0;
+}
 
 
 /*-----------------------+------------------------------------+--------------------------
@@ -91,55 +157,46 @@ double scalprod(double *x, double* y)
 //Given (implicit) parameters xbase and d, solve proj-subprob(xbase->td) with
 //regards to row i only, fill resulting constraint in newRow and return tStar
 //If xbase+td can not be separated, return tStar=t; 
-double tStarForRow(int i, double t, double* newRow)
+double tStarForRow(rlpInstance& r, int i, double t, sparseCut& newRow)
 {
-    if(profits==NULL){
-        profits = new double[::n];
-        order   = new int[::n];
-        toCut = new double[n];
+    const int n = r.n;
+    double**  rows = r.rows;
+    allocProfits(r);
+    if(r.toCut==NULL)
+        r.toCut = new double[n];
+    double* toCut = r.toCut;
+    for(int k=0;k<r.rowNzLen[i];k++){
+        int j    = r.rowNz[i][k];
+        toCut[j] = r.xbase[j] + t*r.d[j];
     }
-    for(int j=0;j<(::n);j++)
-        toCut[j] = xbase[j] + t*d[j];
-    for(int j=0;j<(::n);j++)
-        profits[j] = absVal(rows[i][j]*toCut[j]);
-    sortProfits(order);
-    for(int j=0,jj=order[j]; j<(::gamma); ++j,jj=order[j])
-        if(rows[i][jj]*toCut[jj]>=0)
-            newRow[jj] = rows[i][jj] * (1+DEV_NOM);
-        else
-            newRow[jj] = rows[i][jj] * (1-DEV_NOM);
-    for(int j=::gamma,jj=order[j];j<(::n);++j,jj=order[j])
-        newRow[jj] = rows[i][jj];
-
-    double base    = scalprod(newRow,xbase);
-    double advance = scalprod(newRow,d) * t;
+    robustCutOfRow(r,i,i,toCut,newRow);
+
+    double base    = scalprod(newRow,r.xbase);
+    double advance = scalprod(newRow,r.d) * t;
     if(advance<EPSILON*t)                                    //null advance
         return t;
 
     //Below code can check if xbase is really feasible. Numerical probls not fatal
-    //if((base>rows[i][::n])&&(base<rows[i][::n]+EPSILON*100))
-        //base = rows[i][::n];
-    //if(base> rows[i][::n]) {
-    //    clog<<"diff at "<<i<<"="<<base-rows[i][::n]<<"base="<<base<<","<<rows[i][::n]<<endl;
-    //    for(int i=0;i<n;i++)
-    //        if(newRow[i]*xbase[i]!=0)
-    //            clog<<" "<<newRow[i]<<"/"<<xbase[i]<<" ";
+    //if((base>rows[i][n])&&(base<rows[i][n]+EPSILON*100))
+        //base = rows[i][n];
+    //if(base> rows[i][n]) {
+    //    clog<<"diff at "<<i<<"="<<base-rows[i][n]<<"base="<<base<<","<<rows[i][n]<<endl;
     //}
-    //assert(base <= rows[i][::n]);
-    if( base+advance <= rows[i][::n] + EPSILON)              //can not cut toCut
+    //assert(base <= rows[i][n]);
+    if( base+advance <= rows[i][n] + EPSILON)              //can not cut toCut
         return t;
-    double newtStar = t*((rows[i][::n]-base)/advance);
+    double newtStar = t*((rows[i][n]-base)/advance);
     return newtStar;
 }
 
 //linux coding style: "macros resembling functions may be named in lower case." 
-#define checkBoundsAndPrint(xbase,d,tStar)                                    \
+#define checkBoundsAndPrint(r,ctx,tStar)                                      \
   do{                                                                         \
-    double ubNow   = scalprod(obj,xbase)+tStar*scalprod(obj,d);               \
-    double lbNow   = ::lowerBound; /*from CuttingPlanesEngine.cpp*/           \
+    double ubNow   = scalprod(r.n,r.obj,r.xbase)+tStar*scalprod(r.n,r.obj,r.d);\
+    double lbNow   = ctx.lowerBound; /*from the CuttingPlanesEngine*/         \
 /*  double ubDelta = ubNow - nominalObj;                                      \
     double lbDelta = lbNow - nominalObj;                                   */ \
-    static double bestUb = INT_MAX;                                           \
+    double& bestUb = r.bestUb;                                                \
     if(ubNow<bestUb)                                                          \
         bestUb = ubNow;                                                       \
 /*  clog<<"      (iter, ub) (iter, lb) below, with ub or lb expressed ";      \
@@ -148,23 +205,27 @@ double tStarForRow(int i, double t, double* newRow)
                    <<1000.0*ubDelta/absVal(nominalObj)+1000<<")   ("          \
                    <<setw(4)<<iter<<","<<setw(6)<<setprecision(5)             \
                    <<1000.0*lbDelta/absVal(nominalObj)+1000 <<") "<<endl;  */ \
-    if(iterLowGap==-1)                                                        \
+    if(r.iterLowGap==-1)                                                      \
         if(bestUb-lbNow<0.01*min(absVal(lbNow),absVal(bestUb)) ){             \
-            /*cout<<bestUb<<endl<<absVal(lbNow)<<endl<<iter<<endl;*/          \
-            iterLowGap = iter;                                                \
-            tmLowGap   = getCPUTime() - startCpuTime;                         \
+            /*cout<<bestUb<<endl<<absVal(lbNow)<<endl<<r.iter<<endl;*/        \
+            r.iterLowGap = r.iter;                                            \
+            r.tmLowGap   = getCPUTime() - r.startCpuTime;                     \
         }                                                                     \
   }while(false);
 
 //return -1 if violated cut found; the cut that will be added is: newRow^T x <= rHand
-double projection (double*x, double * newRow,double&rHand)
+double projection (rlpInstance& r, double*x, sparseCut& newRow, cutPlanesCtx& ctx)
 {
+    const int n     = r.n;
+    const int m     = r.m;
+    double**  rows  = r.rows;
+    double*   xbase = r.xbase;
+    double*   d     = r.d;
 
     //1. VARIABLES AND ITERATION/TIME COUNTERS
-    static double startCpuTime  = getCPUTime();
-    iter++;
-    clog<<"Mono-cut projection at iteration "<<iter<<":\n";
-    for(int i=0;i<(::n);i++)
+    r.iter++;
+    clog<<"Mono-cut projection at iteration "<<r.iter<<":\n";
+    for(int i=0;i<n;i++)
         d[i] = x[i]-xbase[i];
     double tStar  = 1;
     double tStarLast = 1;
@@ -178,23 +239,23 @@ double projection (double*x, double * newRow,double&rHand)
     //        out<<setprecision(21)<<xbase[i]<<" ";
     //    out.close();
     //}
-    //for(int i=0;i<(::m);i++)
+    //for(int i=0;i<m;i++)
     //    if(rows[i][n+1]==LESS_THAN_EQ)
-    //    if(tStarForRow(i,tStar,newRow, newRowProd_d)<0.00005)
+    //    if(tStarForRow(r,i,tStar,newRow, newRowProd_d)<0.00005)
     //        clog<<"rrows["<<i<<"][n]-=tt;"<<endl;
     //exit(1);
 
     //2. FIND tStar ANALYZING ROW BY ROW
-    for(int i=0;i<(::m);i++)
+    for(int i=0;i<m;i++)
         if(rows[i][n+1]==LESS_THAN_EQ){
-            double tStarNew = tStarForRow(i,tStar,newRow); 
+            double tStarNew = tStarForRow(r,i,tStar,newRow); 
             while(tStarNew<tStar){
                 bstRow = i;
                 tStarLast = tStar;
                 tStar = tStarNew;
                 clog<<"        better tStar using (2.4) "<<setprecision(11)<<tStar<<endl;
-                    //<<"for slack="<<rows[i][::n]-scalprod(newRow,xbase)<<"; ";
-                tStarNew = tStarForRow(i,tStar,newRow); 
+                    //<<"for slack="<<rows[i][n]-scalprod(newRow,xbase)<<"; ";
+                tStarNew = tStarForRow(r,i,tStar,newRow); 
             }
             if(tStar<=EPSILON){
                 tStar = 0;
@@ -203,7 +264,7 @@ double projection (double*x, double * newRow,double&rHand)
         }
 
     //3. CHECK BOUNDS AND STOP IF OPTIMAL
-    checkBoundsAndPrint(xbase,d,tStar);
+    checkBoundsAndPrint(r,ctx,tStar);
 
     if(tStar==1){                  //x is feasible
         clog<<"        Found tStar=1, the outer solution is feasible"<<endl;
@@ -216,12 +277,11 @@ double projection (double*x, double * newRow,double&rHand)
     //because x+tStar d is not separable and can lead to a cut not separating x+d
     //tStarLast below can eliminate numerical problems associated to tStarLast=~=tStar
     tStarLast = tStar*0.5+0.5;
-    tStarForRow(bstRow,tStarLast,newRow);
-    rHand = rows[bstRow][::n];
+    tStarForRow(r,bstRow,tStarLast,newRow);
 
     #ifndef NDEBUG
-    clog<<"rHnd"<<rHand<<"new*x"<<scalprod(newRow,x)<<" "<<"new*base"<<scalprod(newRow,x)<<endl<<endl;
-    assert(scalprod(newRow,x)>rHand);
+    clog<<"rHnd"<<newRow.rHand<<"new*x"<<scalprod(newRow,x)<<" "<<"new*base"<<scalprod(newRow,x)<<endl<<endl;
+    assert(scalprod(newRow,x)>newRow.rHand);
     #endif
 
     //Code to print solutions and investigate the bang bang effects. Also put 1
@@ -237,8 +297,8 @@ double projection (double*x, double * newRow,double&rHand)
     //5. UPDATE XBASE (INTERIOR POINT)
     for(int i=0;i<n;i++){
         xbase[i] = xbase[i] + 0.1*tStar*d[i];
-        if(xbase[i]<lb[i])
-            xbase[i] = lb[i];
+        if(xbase[i]<r.lb[i])
+            xbase[i] = r.lb[i];
     }
 
     clog<<"        I return tStar="<<tStar<<endl;
@@ -248,17 +308,26 @@ double projection (double*x, double * newRow,double&rHand)
 /*-----------------------+------------------------------------+--------------------------
                          |  Routines for standard separation  |
                          +-----------------------------------*/
-void calcAllSlacks(double* sol)
+void calcAllSlacks(rlpInstance& r, double* sol)
 {
-    if(slack==NULL)
-        slack = new double[::m];
-    for(int i=0;i<(::m);i++)
+    const int n        = r.n;
+    const int m        = r.m;
+    double**  rows     = r.rows;
+    int**     rowNz    = r.rowNz;
+    int*      rowNzLen = r.rowNzLen;
+    if(r.slack==NULL)
+        r.slack = new double[m];
+    double*   slack    = r.slack;
+    for(int i=0;i<m;i++)
         switch((int)rows[i][n+1]){
             case EQUALITY:                    //for equalities, do 
                 slack[i] = -1;                //not care about slacks
                 break;
             case LESS_THAN_EQ:
-                slack[i] = rows[i][n] - scalprod(sol,rows[i]);
+                slack[i] = 0;                 //only the non-zeros of rows[i]
+                for(int k=0;k<rowNzLen[i];k++)
+                    slack[i] += sol[rowNz[i][k]] * rows[i][rowNz[i][k]];
+                slack[i] = rows[i][n] - slack[i];
                 if((slack[i]<=0)&&(slack[i]>=-EPSILON))
                     slack[i] = 0;
                 if(slack[i]<0){
@@ -277,39 +346,43 @@ void calcAllSlacks(double* sol)
         }
 }
 
-void calcMaxDeviations(double *sol)
+void calcMaxDeviations(rlpInstance& r, double *sol)
 {
-    if(maxDev == NULL){
-        maxDev    = new double[::m];
-        profits = new double[::n];
-        order   = new int[::n];
-    }
-    for(int i=0;i<(::m);i++)
-        if(rows[i][::n+1]==LESS_THAN_EQ){
-            for(int j=0;j<(::n);j++)
-               profits[j] = absVal(rows[i][j]*sol[j]); 
-            sortProfits(order);
+    if(r.maxDev == NULL)
+        r.maxDev  = new double[r.m];
+    allocProfits(r);
+    double* maxDev = r.maxDev;
+    classcomp comp;
+    comp.profits = r.profits;
+    for(int i=0;i<r.m;i++)
+        if(r.rows[i][r.n+1]==LESS_THAN_EQ){
+            multiset<int,classcomp> bestGamma(comp);
+            sortProfitsOfRow(r,i,sol,bestGamma);
             maxDev[i] = 0;
-            for(int j=0;j<(::gamma);j++)
-                maxDev[i] += profits[order[j]];
+            for (multiset<int>::iterator it=bestGamma.begin(); it!=bestGamma.end(); ++it)
+                maxDev[i] += r.profits[*it];
             maxDev[i] = maxDev[i]*DEV_NOM;
         }
 }
 
-double separation (double*x, double * newRow,double&rHand)
+double separation (rlpInstance& r, double*x, sparseCut& newRow)
 {
-    static int iter = 0;
-    iter++;
-    calcAllSlacks(x);
-    calcMaxDeviations(x);
+    const int n      = r.n;
+    const int m      = r.m;
+    double**  rows   = r.rows;
+    r.iter++;
+    calcAllSlacks(r,x);
+    calcMaxDeviations(r,x);
+    double*   slack  = r.slack;
+    double*   maxDev = r.maxDev;
 
     int bstRow = 0;
     while(slack[bstRow]<0){   //negative slack means equality constraint
         bstRow++;             //so that slack existence does not make sense
-        assert(bstRow<(::m));
+        assert(bstRow<m);
     }
-    for(int i=bstRow+1;i<(::m);i++)
-      if(rows[i][::n+1]==LESS_THAN_EQ)
+    for(int i=bstRow+1;i<m;i++)
+      if(rows[i][n+1]==LESS_THAN_EQ)
         if(maxDev[i]-slack[i]>=maxDev[bstRow]-slack[bstRow])
             bstRow = i;
     
@@ -322,23 +395,9 @@ double separation (double*x, double * newRow,double&rHand)
     if(maxDev[bstRow]<=slack[bstRow])
         return 1;                                         //opt sol
 
-    for(int j=0;j<(::n);j++)
-        profits[j] = absVal(rows[bstRow][j]*x[j]); 
-    sortProfits(order);
-
-    if(rows[bstRow][::n+1]==LESS_THAN_EQ){               //adding <= ineq
-        rHand = rows[bstRow][::n];
-        for(int j=0,jj=order[j];j<(::gamma);++j,jj=order[j])
-            if(rows[bstRow][jj]*x[jj]>=0)
-                newRow[jj] = rows[bstRow][jj] * (1+DEV_NOM);
-            else
-                newRow[jj] = rows[bstRow][jj] * (1-DEV_NOM);
-        for(int j=::gamma,jj=order[j];j<(::n);++j,jj=order[j])
-            newRow[jj] = rows[bstRow][jj];
-    }
-    //clog<<"max violation:"<<setw(10)<<slack[bstRow] - maxDev[bstRow];//<<"/profmax"<<setw(9)<<profits[order[0]];
-    //for(int j=0,jj=order[j];j<(::gamma);++j,jj=order[j])
-    //    clog<<setw(5)<<jj;
+    if(rows[bstRow][n+1]==LESS_THAN_EQ)                 //adding <= ineq
+        robustCutOfRow(r,bstRow,bstRow,x,newRow);
+    //clog<<"max violation:"<<setw(10)<<slack[bstRow] - maxDev[bstRow];
     return slack[bstRow] - maxDev[bstRow];
 }
 
@@ -355,23 +414,26 @@ int compare_descending (const void * a, const void * b)
     return 0;
 }
 
-double separation_multi (double*x, double * newRow,double&rHand,
-                         double**newRows, double*newRHands, int& newMore,
-                         bool multi_cuts_limited)
+double separation_multi (rlpInstance& r, double*x, sparseCut& newRow, sparseCut* newRows,
+                         int& newMore, bool multi_cuts_limited)
 {
-    static int iter = 0;
-    iter++;
-    clog<<"Multi-cut separation iteration "<<iter<<":";
-    calcAllSlacks(x);
-    calcMaxDeviations(x);
+    const int n      = r.n;
+    const int m      = r.m;
+    double**  rows   = r.rows;
+    r.iter++;
+    clog<<"Multi-cut separation iteration "<<r.iter<<":";
+    calcAllSlacks(r,x);
+    calcMaxDeviations(r,x);
+    double*   slack  = r.slack;
+    double*   maxDev = r.maxDev;
 
     int bstRow = 0;
     while(slack[bstRow]<0){   //negative slack means equality constraint
         bstRow++;             //so that slack existence does not make sense
-        assert(bstRow<(::m));
+        assert(bstRow<m);
     }
-    for(int i=bstRow+1;i<(::m);i++)
-        if(rows[i][::n+1]==LESS_THAN_EQ)
+    for(int i=bstRow+1;i<m;i++)
+        if(rows[i][n+1]==LESS_THAN_EQ)
             if(maxDev[i]-slack[i]>=maxDev[bstRow]-slack[bstRow])
                 bstRow = i;
     
@@ -384,36 +446,22 @@ double separation_multi (double*x, double * newRow,double&rHand,
     if(maxDev[bstRow]<=slack[bstRow])
         return 1;                                         //opt sol
 
-    for(int j=0;j<(::n);j++)
-        profits[j] = absVal(rows[bstRow][j]*x[j]); 
-    sortProfits(order);
-
-    if(rows[bstRow][::n+1]==LESS_THAN_EQ){               //adding <= ineq
-        rHand = rows[bstRow][::n];
-        for(int j=0,jj=order[j];j<(::gamma);++j,jj=order[j])
-            if(rows[bstRow][jj]*x[jj]>=0)
-                newRow[jj] = rows[bstRow][jj] * (1+DEV_NOM);
-            else
-                newRow[jj] = rows[bstRow][jj] * (1-DEV_NOM);
-        for(int j=::gamma,jj=order[j];j<(::n);++j,jj=order[j])
-            newRow[jj] = rows[bstRow][jj];
-    }
-    //clog<<"max violation:"<<setw(10)<<slack[bstRow] - maxDev[bstRow];//<<"/profmax"<<setw(9)<<profits[order[0]];
-    //for(int j=0,jj=order[j];j<(::gamma);++j,jj=order[j])
-    //    clog<<setw(5)<<jj;
+    if(rows[bstRow][n+1]==LESS_THAN_EQ)                 //adding <= ineq
+        robustCutOfRow(r,bstRow,bstRow,x,newRow);
+    //clog<<"max violation:"<<setw(10)<<slack[bstRow] - maxDev[bstRow];
 
 
     //Now I add more multiple cuts
     double min_excess = 0;
     if(multi_cuts_limited){
-        double* excess = new double[::m];
-        for(int ii=0;ii<(::m);ii++){
-            if(rows[ii][::n+1]==LESS_THAN_EQ)
+        double* excess = new double[m];
+        for(int ii=0;ii<m;ii++){
+            if(rows[ii][n+1]==LESS_THAN_EQ)
                 excess[ii] = maxDev[ii]-slack[ii];
             else
                 excess[ii] = INT_MIN;
         }
-        qsort(excess, ::m, sizeof(double), compare_descending);
+        qsort(excess, m, sizeof(double), compare_descending);
         min_excess = excess[5];
         if(min_excess<0)
             min_excess=0;
@@ -436,22 +484,13 @@ double separation_multi (double*x, double * newRow,double&rHand,
     while(slack[row]<0)    //negative slack means equality constraint
         row++;             //so that slack existence does not make sense
     
-    for(;row<(::m);row++)
+    for(;row<m;row++)
       if(row!=bstRow)
-        if(rows[row][::n+1]==LESS_THAN_EQ)
+        if(rows[row][n+1]==LESS_THAN_EQ)
             if(maxDev[row]-slack[row]>min_excess){
-                for(int j=0;j<(::n);j++)
-                    profits[j] = absVal(rows[row][j]*x[j]); 
-                sortProfits(order);
-                newRHands[newMore] = rows[row][::n];
-                for(int j=0,jj=order[j];j<(::gamma);++j,jj=order[j])
-                    if(rows[bstRow][jj]*x[jj]>=0)
-                        newRows[newMore][jj] = rows[row][jj] * (1+DEV_NOM);
-                    else
-                        newRows[newMore][jj] = rows[row][jj] * (1-DEV_NOM);
-                for(int j=::gamma,jj=order[j];j<(::n);++j,jj=order[j])
-                    newRows[newMore][jj] = rows[row][jj];
-                if(total_multi_cuts+(newMore+1)<10000)
+                //deviation signs taken from bstRow, as in the dense version
+                robustCutOfRow(r,row,bstRow,x,newRows[newMore]);
+                if(r.total_multi_cuts+(newMore+1)<10000)
                     newMore++;
             }
     clog<<"        multiple cuts added: "<<(newMore+1)<<endl;
@@ -459,16 +498,19 @@ double separation_multi (double*x, double * newRow,double&rHand,
 }
 
 //return -1 if violated cut found; the cut that will be added is: newRow^T x <= rHand
-double projection_multi (double*x, double * newRow,double&rHand,
-                         double**newRows, double*newRHands, int& newMore,
-                         bool multi_cuts_limited)
+double projection_multi (rlpInstance& r, double*x, sparseCut& newRow, sparseCut* newRows,
+                         int& newMore, cutPlanesCtx& ctx, bool multi_cuts_limited)
 {
+    const int n     = r.n;
+    const int m     = r.m;
+    double**  rows  = r.rows;
+    double*   xbase = r.xbase;
+    double*   d     = r.d;
 
     //1. VARIABLES AND ITERATION/TIME COUNTERS
-    static double startCpuTime  = getCPUTime();
-    iter++;
-    clog<<"Multi-cut projection at iteration "<<iter<<":"<<endl;
-    for(int i=0;i<(::n);i++)
+    r.iter++;
+    clog<<"Multi-cut projection at iteration "<<r.iter<<":"<<endl;
+    for(int i=0;i<n;i++)
         d[i] = x[i]-xbase[i];
     double tStar  = 1;
     double tStarLast = 1;
@@ -482,20 +524,19 @@ double projection_multi (double*x, double * newRow,double&rHand,
     //        out<<setprecision(21)<<xbase[i]<<" ";
     //    out.close();
     //}
-    //for(int i=0;i<(::m);i++)
+    //for(int i=0;i<m;i++)
     //    if(rows[i][n+1]==LESS_THAN_EQ)
-    //    if(tStarForRow(i,tStar,newRow, newRowProd_d)<0.00005)
+    //    if(tStarForRow(r,i,tStar,newRow, newRowProd_d)<0.00005)
     //        clog<<"rrows["<<i<<"][n]-=tt;"<<endl;
     //exit(1);
 
     //2. FIND tStar ANALYZING ROW BY ROW
     newMore = 0;
-    for(int i=0;i<(::m);i++)
+    for(int i=0;i<m;i++)
         if(rows[i][n+1]==LESS_THAN_EQ){
-            double tStarNew = tStarForRow(i,tStar,newRows[newMore]); 
-            newRHands[newMore] = rows[i][::n];
+            double tStarNew = tStarForRow(r,i,tStar,newRows[newMore]); 
             if((tStarNew<tStar) || (!multi_cuts_limited) )
-              if(total_multi_cuts+(newMore+1)<10000)
+              if(r.total_multi_cuts+(newMore+1)<10000)
                 newMore++;
             //if(newMore>5) newMore=5;
             while(tStarNew<tStar){
@@ -504,12 +545,11 @@ double projection_multi (double*x, double * newRow,double&rHand,
                 tStar = tStarNew;
                 clog<<"        better tStar using eq. (2.4): "<<setprecision(8)<<tStar<<endl;
                     //<< "at i="<<i;
-                    //<<"for slack="<<rows[i][::n]-scalprod(newRow,xbase)<<"; ";
-                //tStarNew = tStarForRow(i,tStar,newRow); 
-                tStarNew = tStarForRow(i,tStar,newRows[newMore]); 
-                newRHands[newMore] = rows[i][::n];
+                    //<<"for slack="<<rows[i][n]-scalprod(newRow,xbase)<<"; ";
+                //tStarNew = tStarForRow(r,i,tStar,newRow); 
+                tStarNew = tStarForRow(r,i,tStar,newRows[newMore]); 
                 if((tStarNew<tStar) || (!multi_cuts_limited) )
-                    if(total_multi_cuts+(newMore+1)<10000)
+                    if(r.total_multi_cuts+(newMore+1)<10000)
                         newMore++;
                 //if(newMore>5) newMore=5;
             }
@@ -520,7 +560,7 @@ double projection_multi (double*x, double * newRow,double&rHand,
         }
 
     //3. CHECK BOUNDS AND STOP IF OPTIMAL
-    checkBoundsAndPrint(xbase,d,tStar);
+    checkBoundsAndPrint(r,ctx,tStar);
 
     if(tStar==1){                  //x is feasible
         clog<<"        found tStar=1, i.e., outer solution is feasible"<<endl;
@@ -535,12 +575,11 @@ double projection_multi (double*x, double * newRow,double&rHand,
 
     //This cut will actually be returned twice, because it is already newRows
     tStarLast = tStar*0.5+0.5;
-    tStarForRow(bstRow,tStarLast,newRow);
-    rHand = rows[bstRow][::n];
+    tStarForRow(r,bstRow,tStarLast,newRow);
 
     #ifndef NDEBUG
-    clog<<"rHnd"<<rHand<<"new*x"<<scalprod(newRow,x)<<" "<<"new*base"<<scalprod(newRow,x)<<endl<<endl;
-    assert(scalprod(newRow,x)>rHand);
+    clog<<"rHnd"<<newRow.rHand<<"new*x"<<scalprod(newRow,x)<<" "<<"new*base"<<scalprod(newRow,x)<<endl<<endl;
+    assert(scalprod(newRow,x)>newRow.rHand);
     #endif
 
     //Code to print solutions and investigate the bang bang effects. Also put 1
@@ -556,11 +595,11 @@ double projection_multi (double*x, double * newRow,double&rHand,
     //5. UPDATE XBASE (INTERIOR POINT)
     for(int i=0;i<n;i++){
         xbase[i] = xbase[i] + 0.1*tStar*d[i];
-        if(xbase[i]<lb[i])
-            xbase[i] = lb[i];
+        if(xbase[i]<r.lb[i])
+            xbase[i] = r.lb[i];
     }
     clog<<"        I return tStar="<<tStar<<" Multiple cuts added: "<<(newMore+1)<<endl;
-    //total_multi_cuts+=(newMore+1);
+    //r.total_multi_cuts+=(newMore+1);
     return -1;
 }
 
@@ -3,33 +3,62 @@
          +------------------------------------------------------------------------*/
 #ifndef SUBPROB_H
 #define SUBPROB_H
+#include "../../src_shared/CuttingPlanesEngine.h"   //for sparseCut
 
 #define EQUALITY     0
 #define LESS_THAN_EQ 1
 
-extern int      n;               //number of variables
-extern int      m;               //number of initial rows
-extern double*  obj;
-extern double*  lb;
-extern double*  xbase;
-extern double*  d;         //used to solve proj_subprob(xbase->d)
-extern double** rows;            //rows[...][n] = rHand, rows[...][n+1]=0/-1/1 ~ ==/>=/<=
-extern int      gamma;
-extern double   nominalObj;
-extern int      iterLowGap;//iteration when ub<=bstLowerBound*1.2
-extern double   tmLowGap  ;//tm for above
+//An instance and the state of its sub-problems. There are no globals in the sub-problems,
+//so that several instances (each with its rlpInstance) can be solved in parallel threads
+typedef struct rlpInstance_{
+    int      n;               //number of variables
+    int      m;               //number of initial rows
+    int      gamma;           //uncertainty budget
+    double*  obj;
+    double*  lb;
+    double*  ub;
+    double** rows;            //rows[...][n] = rHand, rows[...][n+1]=0/-1/1 ~ ==/>=/<=
+    int**    rowNz;           //non-zero positions of each row (see inout.h)
+    int*     rowNzLen;
+    double*  xbase;           //the interior point of the projective method
+    double*  d;               //used to solve proj_subprob(xbase->d)
+    //Below: the state of the sub-problems, see initSubprobs() and freeSubprobs()
+    double*  slack;
+    double*  maxDev;          //maximum deviation in a robust cut using gamma terms
+    int*     devIdx;          //the (at most gamma) positions that deviate in a robust cut
+    char*    deviates;        //deviates[j]=1 iff j is in devIdx
+    double*  profits;         //sortProfitsOfRow puts max profits first
+    double*  toCut;
+    int      iter;
+    double   bestUb;          //best upper bound of the projective method
+    double   startCpuTime;
+    double   tmSort;          //time spent sorting profits
+    int      iterLowGap;      //iteration when ub<=bstLowerBound*1.2
+    double   tmLowGap;        //tm for above
+    int      total_multi_cuts;
+    bool     multi_cuts_per_round;
+} rlpInstance;
+
+//empty state of the sub-problems of r (the buffers are allocated at first use), r.xbase
+//and r.d are not changed
+void initSubprobs(rlpInstance& r);
+//release the state of the sub-problems of r
+void freeSubprobs(rlpInstance& r);
 
 double absVal(double);
-double scalprod(double *x, double* y);
-double separation (double*x, double * newRow,double&newRHand);
-double projection (double*x, double * newRow,double&newRHand);
+double scalprod(int n, double *x, double* y);
+//all routines below write the cuts newRow^T x <= rHand in sparse form, scanning only
+//the non-zeros of the nominal rows. A negative return value means x is separated
+//The projective routines read ctx.lowerBound, the master objective value
+double separation (rlpInstance& r, double*x, sparseCut& newRow);
+double projection (rlpInstance& r, double*x, sparseCut& newRow, cutPlanesCtx& ctx);
 
-double separation_multi (double*x, double * newRow,double&rHand,
-                         double**newRows, double*newRHands, int& newMore,
+double separation_multi (rlpInstance& r, double*x, sparseCut& newRow, sparseCut* newRows,
+                         int& newMore,
                          bool multi_cuts_limited//if true, add maximum 10 cuts per iter
                          );
-double projection_multi (double*x, double * newRow,double&newRHand,
-                         double**newRows, double*newRHands, int& newMore,
+double projection_multi (rlpInstance& r, double*x, sparseCut& newRow, sparseCut* newRows,
+                         int& newMore, cutPlanesCtx& ctx,
                          bool multi_cuts_limited//if true, add only cuts that decrease tStar
                          );
 
@@ -1,6 +1,6 @@
 /*----------------------------------------------------------------------------------------------+
 |               Cutting Planes Engine to solve an LP adding constraints one by one              |
-|                   - using the cheshire cat technique, no need to include cplex                | 
+|                   - using the cheshire cat technique, no need to include solver               | 
 |                     .h headers in all files that include CuttingPlanesEngine.h,               |
 |                     significantly speeding-up compilation                                     |    
 ---------+-------------------------------------------------------------------------+------------+
@@ -9,29 +9,17 @@
 
 #include "CuttingPlanesEngine.h"
 #include "general.h"                //only useful for getCPUTime()
+#include "lpBackend.h"              //the LP solver (cplex or glpk), chosen when linking
 #include <cstdlib>
+#include <climits>
+#include <iostream>
 #include <vector>
 #include <cmath>
-#include <ilcplex/ilocplex.h>                    
+#include <thread>
 using namespace std;
 
 #define RANDOMIZE_MASTER_SOLVE
 
-//The cples parameters change from version to version. The macros below 
-//may prevent such problems, based on a CPLEXVER that can be defined by the
-//compilation line using option -D. It should contain 3 digits
-#if !defined CPLEXVER ||  (CPLEXVER>=129)
-    #define TIME_LIMIT_PARAM            IloCplex::Param::TimeLimit
-    #define MAX_THREADS_PARAM           IloCplex::Param::Threads
-    #define NUMERICAL_EMPHASIS_PARAM    IloCplex::Param::Emphasis::Numerical
-    #define FEASIBLE_TOLERANCE_PARAM    IloCplex::Param::Simplex::Tolerances::Feasibility
-#else
-    #define TIME_LIMIT_PARAM            IloCplex::TiLim
-    #define MAX_THREADS_PARAM           IloCplex::Threads
-    #define NUMERICAL_EMPHASIS_PARAM    IloCplex::NumericalEmphasis
-    #define FEASIBLE_TOLERANCE_PARAM    IloCplex::EpRHS
-#endif
-
 
 
 ////TESTING A CERTAIN FEASIBLE PRIMAL IS REALLY FEASIBLE
@@ -40,81 +28,75 @@ using namespace std;
 int zz[1100];
 #endif
 
-double lowerBound;                             //a global visible anywhere
-double upperBound;                             //a global visible anywhere
-int    switchToIntVarsNow;                     //a global usable from cutSeprt
-//#define TMP_CUT_ERASER
-#ifdef TMP_CUT_ERASER
-int recordedConstr = 0;
-#endif
-class cplexCheshireData{                       //From other files, one can refer to this struct
-    public: 
-    IloEnv         env;                        //without needing to include cplex headers
-    IloModel       model;
-    IloNumVarArray vars;
-    IloCplex       cplex ;
-    IloNumArray    lb ;
-    IloNumArray    ub ;
-    IloRangeArray cuts;                     
+//A cut generated by runCutPlanes can be purged from the LP when it stays non-binding
+//(zero dual) for too long. The lpBackend keeps the row, so that the cut keeps its id
+//and can be re-injected later with a simple addRowBackToLP. The non-zeros are copied
+//to check cheaply (without the solver) if the cut is violated by the current primals
+class cutPoolEntry{
+    public:
+    int purgeable;                             //only cuts from runCutPlanes can be purged
+    int inLP;                                  //0 if the cut is in the off-LP pool
+    int age;                                   //consecutive rounds with zero dual
+    vector<int>    idx;                        //non-zeros, only for purgeable cuts
+    vector<double> val;
+    double lhsMin, lhsMax;                     //the range lhsMin <= val^T x <= lhsMax
+    cutPoolEntry(): purgeable(0), inLP(1), age(0), lhsMin(0), lhsMax(0){};
+};
+class engineCheshireData{                      //From other files, one can refer to this struct
+    public:                                    //without needing to include lpBackend.h
+    lpBackend      lp;                         //row i of lp is the cut of id i
+    vector<cutPoolEntry> pool;                 //pool[i] describes cut i, if i<pool.size()
     #ifdef RANDOMIZE_MASTER_SOLVE
     int itersRandomized;
     double* objCoefsCopy = NULL;               //the randomizing is done by modifying original
                                                //objective function. We need a copy of it.
     #endif
-    #ifdef TMP_CUT_ERASER
-    IloRange rrecConstr;
-    #endif
-    cplexCheshireData(int n):
-            env(), model(env), vars(env,n,INT_MIN,INT_MAX), cplex (env),
-            lb(env,n), ub (env,n), cuts(env){
+    engineCheshireData(int n): lp(n){
     };
+};
 
+//The rows of a batch in the format of lpBackend::addRows
+class rowBatch{
+    public:
+    vector<int>    start;                      //row k has the non-zeros start[k]..start[k+1]-1
+    vector<int>    idx;
+    vector<double> val;
+    vector<double> lhsMin, lhsMax;
+    rowBatch(): start(1,0){};
+    int size(){return lhsMin.size();};
+    void addCoef(int i, double v){
+        idx.push_back(i);
+        val.push_back(v);
+    };
+    void endRow(double mn, double mx){
+        lhsMin.push_back(mn);
+        lhsMax.push_back(mx);
+        start.push_back(idx.size());
+    };
+    void clear(){
+        start.assign(1,0);
+        idx.clear();
+        val.clear();
+        lhsMin.clear();
+        lhsMax.clear();
+    };
 };
 
 void CuttingPlanesEngine::removeVar(int outIdx)
 {
-    d.vars[outIdx].end();
-    d.vars.remove(outIdx);
-    d.lb.remove(outIdx);
-    d.ub.remove(outIdx);
+    d.lp.removeVar(outIdx);
     n--;
-    #ifdef TMP_CUT_ERASER
-    if(outIdx==recordedConstr){
-        CPLOG("Erasing"<<d.rrecConstr<<endl);
-        d.rrecConstr.end();
-        //d.model.remove(d.rrecConstr);
-    }
-    #endif
-
 }
 void CuttingPlanesEngine::setVarBounds(int i, double lbnd, double ubnd)
 {
-    d.lb[i] = lbnd;
-    d.ub[i] = ubnd;
-    d.model.add(d.vars[i]>=d.lb[i]);
-    d.model.add(d.vars[i]<=d.ub[i]);
+    d.lp.setVarBounds(i, lbnd, ubnd);
 }
 void CuttingPlanesEngine::addVar(double objCoef, double min, double max, int swapOK)
 {
-    IloObjective obj = d.cplex.getObjective();
-    d.vars.add(obj(objCoef));
+    d.lp.addVar(objCoef, min, max);
     n++;
-    d.lb.add(min);
-    d.ub.add(max);
-
-    d.model.add(d.vars[n-1]>=d.lb[n-1]);
-    d.model.add(d.vars[n-1]<=d.ub[n-1]);
-    if(swapOK){
-        IloNumVar tmp = d.vars[n-1];
-        d.vars[n-1] = d.vars[n-2];
-        d.vars[n-2] = tmp; 
-        double  tmpd= d.lb[n-1];
-        d.lb[n-1]   = d.lb[n-2];
-        d.lb[n-2]   = tmpd;
-        tmpd= d.ub[n-1];
-        d.ub[n-1]   = d.ub[n-2];
-        d.ub[n-2]   = tmpd;
-    }
+    if(swapOK)
+        d.lp.swapVars(n-1, n-2);
     //delete[] primals;
     if(primals!=NULL)
         delete[] primals;
@@ -128,9 +110,10 @@ void CuttingPlanesEngine::init()
 {
     //by default there is no log output
     cplog.setstate(std::ios_base::failbit);
-    ::upperBound = INT_MAX;
-    ::lowerBound = INT_MIN;
-    ::switchToIntVarsNow = 0;
+    ctx.upperBound = INT_MAX;
+    ctx.lowerBound = INT_MIN;
+    ctx.switchToIntVarsNow = 0;
+    ctx.userData   = NULL;
     timeoutSet = -1;
     #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
     suboptimal = 0;
@@ -141,27 +124,40 @@ void CuttingPlanesEngine::init()
         for(int ij=0;ij<1100;ij++)zz[ij]=0;
         zz[0]=374;zz[9]=285;zz[12]=198;zz[14]=521;zz[19]=108;zz[44]=628;zz[45]=389;zz[58]=1122;zz[62]=399;zz[79]=314;zz[83]=309;zz[86]=367;zz[90]=879;zz[96]=174;zz[97]=226;zz[108]=54;zz[109]=212;zz[112]=187;zz[114]=90;zz[115]=178;zz[118]=348;zz[122]=297;zz[141]=342;zz[145]=503;
     #endif
-    d.cplex.extract(d.model);
-
-    //The number of threads cplex can use (at maximum)
-    d.cplex.setParam(MAX_THREADS_PARAM,THREADS);
+    //The number of threads the solver can use (at maximum)
+    d.lp.setThreads(THREADS);
 
     //feasibility tolerance: Specifies the feasibility tolerance, the degree  
     //to which the basic variables of a model may violate their bounds.
-    d.cplex.setParam(FEASIBLE_TOLERANCE_PARAM, 1e-9);
+    d.lp.setFeasibilityTol(1e-9);
     
-    d.cplex.setParam(NUMERICAL_EMPHASIS_PARAM, true);
+    d.lp.setNumericalEmphasis(1);
 
     #ifdef NO_CPLEX_OUTPUT
-    d.cplex.setOut(d.env.getNullStream());
-    d.cplex.setError(d.env.getNullStream());
-    //This says when it is MIP
-    d.cplex.setWarning(d.env.getNullStream());
+    d.lp.disableOutput();
     #endif 
     primals   = new double[n];
     intStatus = new int[n];
     noRows           = 0;
     tmOnlySolve      = 0;
+    tmInsertCuts     = 0;
+    lastTmInsertCuts = 0;
+    warmStart        = 0;
+    pipelined        = 0;
+    statsCallback    = NULL;
+    statsUserData    = NULL;
+    statsOut         = NULL;
+    statsFormat      = ITER_STATS_CSV;
+    nrStaleCuts      = 0;
+    deferBounds      = 0;
+    boundPending     = 0;
+    pendingBound     = 0;
+    nrSimplexIters   = 0;
+    lastNrSimplexIters = 0;
+    cutPoolMaxAge    = 0;                      //no purging by default
+    cutPoolSize      = 0;
+    nrPurgedCuts     = 0;
+    nrReactivatedCuts= 0;
     intVars          = 0;
     totalNrCoefs     = 0;
     maximize         = 0;
@@ -173,16 +169,7 @@ int  CuttingPlanesEngine::nbIntVars()
 }
 void CuttingPlanesEngine::setToleranceParamToEpsilon()
 {
-     //the first below si an old version (<Cplex 2.6) of second below
-     #ifndef CPLEXVER
-        d.cplex.setParam(IloCplex::EpInt, EPS);
-     #else
-        //CPLEXVER passed in command line via -D. It should contain 3 digits
-        //see the beginning of the file
-        #if (CPLEXVER>=126)
-            d.cplex.setParam(IloCplex::Param::MIP::Tolerances::Integrality,EPS);//you said cplex >=12.6
-        #endif
-     #endif
+     d.lp.setIntegralityTol(EPS);
 }
 void CuttingPlanesEngine::turnVarInteger(int i)
 {
@@ -191,7 +178,7 @@ void CuttingPlanesEngine::turnVarInteger(int i)
         return;
      }
      CPLOG("Turning variable " << i <<" integer...");
-     d.model.add(IloConversion(d.env, d.vars[i], ILOINT));
+     d.lp.setVarInteger(i);
      setToleranceParamToEpsilon();
      intVars ++;
      intStatus[i] = 1;
@@ -200,16 +187,16 @@ void CuttingPlanesEngine::turnVarInteger(int i)
 void CuttingPlanesEngine::turnAllVarsInteger()
 {
     if(intVars==0){
-        d.model.add(IloConversion(d.env, d.vars, ILOINT));
+        for(int i=0;i<n;i++){
+             d.lp.setVarInteger(i);
+             intStatus[i] = 1;
+        }
         setToleranceParamToEpsilon();
         intVars =n ;
-        for(int i=0;i<n;i++)
-             intStatus[i] = 1;
         return ;
     }
     if(intVars<n){
         CPLOG("\n\nMaking all variables DISCRETE******************************************************** \n\n\n");
-        //d.model.add(IloConversion(d.env, d.vars, ILOINT));
         for(int i=0;i<n;i++)
             turnVarInteger(i);
     }
@@ -225,10 +212,11 @@ void CuttingPlanesEngine::printProgressMsg(ostream& cstream)
 }
 CuttingPlanesEngine::CuttingPlanesEngine(int nrVars, cutSeprtSimple_t cutSeprtSimple): 
                            cplog(clog.rdbuf()),//disabled by default via failbit
-                           n(nrVars), currObj(0), d(*new cplexCheshireData(n)),
+                           n(nrVars), currObj(0), d(*new engineCheshireData(n)),
                            internalCutSeprtSimple(cutSeprtSimple),
                            internalCutSeprtSolver(NULL),
                            internalCutSeprtExtended(NULL),
+                           internalCutSeprtSparse(NULL),
                            maxMoreConstr(0),
                            turnIntegerEnd(0)
 {
@@ -236,10 +224,11 @@ CuttingPlanesEngine::CuttingPlanesEngine(int nrVars, cutSeprtSimple_t cutSeprtSi
 }
 CuttingPlanesEngine::CuttingPlanesEngine(int nrVars, cutSeprtSolver_t cutSeprtSolver): 
                            cplog(clog.rdbuf()),//disabled by default via failbit
-                           n(nrVars), currObj(0), d(*new cplexCheshireData(n)),
+                           n(nrVars), currObj(0), d(*new engineCheshireData(n)),
                            internalCutSeprtSimple(NULL),
                            internalCutSeprtSolver(cutSeprtSolver),
                            internalCutSeprtExtended(NULL),
+                           internalCutSeprtSparse(NULL),
                            maxMoreConstr(0),
                            turnIntegerEnd(0)
 {
@@ -247,10 +236,23 @@ CuttingPlanesEngine::CuttingPlanesEngine(int nrVars, cutSeprtSolver_t cutSeprtSo
 }
 CuttingPlanesEngine::CuttingPlanesEngine(int nrVars, cutSeprtExtended_t cutSeprtExtended, int maxMoreConstrToReturn): 
                            cplog(clog.rdbuf()),//disabled by default via failbit
-                           n(nrVars), currObj(0), d(*new cplexCheshireData(n)),
+                           n(nrVars), currObj(0), d(*new engineCheshireData(n)),
                            internalCutSeprtSimple(NULL),
                            internalCutSeprtSolver(NULL),
                            internalCutSeprtExtended(cutSeprtExtended),
+                           internalCutSeprtSparse(NULL),
+                           maxMoreConstr(maxMoreConstrToReturn),
+                           turnIntegerEnd(0)
+{
+    init();
+}
+CuttingPlanesEngine::CuttingPlanesEngine(int nrVars, cutSeprtSparse_t cutSeprtSparse, int maxMoreConstrToReturn): 
+                           cplog(clog.rdbuf()),//disabled by default via failbit
+                           n(nrVars), currObj(0), d(*new engineCheshireData(n)),
+                           internalCutSeprtSimple(NULL),
+                           internalCutSeprtSolver(NULL),
+                           internalCutSeprtExtended(NULL),
+                           internalCutSeprtSparse(cutSeprtSparse),
                            maxMoreConstr(maxMoreConstrToReturn),
                            turnIntegerEnd(0)
 {
@@ -259,75 +261,49 @@ CuttingPlanesEngine::CuttingPlanesEngine(int nrVars, cutSeprtExtended_t cutSeprt
 
 CuttingPlanesEngine::~CuttingPlanesEngine()
 { 
-    d.lb.end();
-    d.ub.end();
-    for(int i=noRows-1;i>=0;i--)
-        modelDelCut(i);
-    d.cuts.end();
-    d.vars.end();
-    d.model.end();
-    d.env.end();
+    #ifdef RANDOMIZE_MASTER_SOLVE
+    delete[] d.objCoefsCopy;
+    #endif
+    delete &d;                        //the lpBackend destructor releases the solver data
     delete[] primals;
     delete[] intStatus;
 }
 void CuttingPlanesEngine::setVarBounds(double * varLb, double * varUb)
 {
-    for (int i=0;i<n;i++){
-        d.model.add(d.vars[i]>=varLb[i]);
-        d.model.add(d.vars[i]<=varUb[i]);
-        d.lb[i] = varLb[i];
-        d.ub[i] = varUb[i];
-    }
-    d.vars.setBounds(d.lb,d.ub);
+    for (int i=0;i<n;i++)
+        d.lp.setVarBounds(i, varLb[i], varUb[i]);
 }
 void CuttingPlanesEngine::setVarBounds(double varLb, double  varUb)
 {
-    for (int i=0;i<n;i++){
-        d.lb[i] = varLb;
-        d.ub[i] = varUb;
-        d.model.add(d.vars[i]>=d.lb[i]);
-        d.model.add(d.vars[i]<=d.ub[i]);
-    }
-    d.vars.setBounds(d.lb,d.ub);
+    for (int i=0;i<n;i++)
+        d.lp.setVarBounds(i, varLb, varUb);
 }
 void CuttingPlanesEngine::setVarLowerBoundsOnly(double varLb)
 {
-    for (int i=0;i<n;i++){
-        d.lb[i] = varLb;
-        d.ub[i] = IloInfinity;
-        d.model.add(d.vars[i]>=d.lb[i]);
-    }
-    d.vars.setBounds(d.lb,d.ub);
+    for (int i=0;i<n;i++)
+        d.lp.setVarBounds(i, varLb, d.lp.lpInfinity());
 }
-#define ADD_OBJ(MinOrMax)                                    \
-    IloExpr expr(d.env);                                     \
-    for(int i=0;i<n;i++)                                     \
-        if(abs(coefs[i])>EPS)                                \
-            expr+=coefs[i]* d.vars[i];                       \
-    IloObjective obj(d.env, expr, IloObjective::MinOrMax);   \
-    d.model.add(obj);                                        \
-    expr.end();
 void CuttingPlanesEngine::setObjCoefsMaximize(int * coefs)
 {
-    ADD_OBJ(Maximize);
+    d.lp.setObj(coefs, 1);
     maximize = 1;
     currObj  = INT_MAX;
 }
 void CuttingPlanesEngine::setObjCoefsMaximize(double * coefs)
 {
-    ADD_OBJ(Maximize);
+    d.lp.setObj(coefs, 1);
     maximize = 1;
     currObj  = INT_MAX;
 }
 void CuttingPlanesEngine::setObjCoefsMinimize(int * coefs)
 {
-    ADD_OBJ(Minimize);
+    d.lp.setObj(coefs, 0);
     maximize = 0;
     currObj = INT_MIN;
 }
 void CuttingPlanesEngine::setObjCoefsMinimize(double * coefs)
 {
-    ADD_OBJ(Minimize);
+    d.lp.setObj(coefs, 0);
     maximize = 0;
     currObj = INT_MIN;
 }
@@ -381,43 +357,132 @@ void CuttingPlanesEngine::alwaysTurnIntegerInTheEnd()
 {
     turnIntegerEnd = 1;
 }
+cutPlanesCtx& CuttingPlanesEngine::getCtx()
+{
+    return ctx;
+}
+void CuttingPlanesEngine::setSeparatorData(void* userData)
+{
+    ctx.userData = userData;
+}
+double CuttingPlanesEngine::getLowerBound()
+{
+    return ctx.lowerBound;
+}
+double CuttingPlanesEngine::getUpperBound()
+{
+    return ctx.upperBound;
+}
 int CuttingPlanesEngine::getNbCuts()
 {
     return noRows;
 }
 double CuttingPlanesEngine::getCutDualVal(int i)
 {
-    return d.cplex.getDual(d.cuts[i]);
+    if((i<(int)d.pool.size())&&(!d.pool[i].inLP))
+        return 0;                              //a pooled cut is out of the LP
+    return d.lp.getDual(i);
 }
 double CuttingPlanesEngine::getCutRightHand(int i)
 {
-    return d.cuts[i].getLB();
+    return d.lp.getRowLB(i);
 }
 void CuttingPlanesEngine::modelDelCut(int i)
 {
-    d.cuts[i].end();
+    d.lp.delRow(i);
 }
-int CuttingPlanesEngine::modelAddCut(double * coefs, double rightHand)
+
+//Below helpers only append the non-zeros and the range of a cut to a batch, they do
+//not add anything to the model. Return value: the number of non-zeros appended
+//Their cplog is only read by the debug output: it stays unnamed in release builds
+#ifdef NDEBUG
+    #define DEBUG_PARAM(x)
+#else
+    #define DEBUG_PARAM(x) x
+#endif
+static int sparseCutToBatch(rowBatch& batch, const sparseCut& cut, double infty,
+                            ostream& DEBUG_PARAM(cplog))
 {
-    int i;
-    IloExpr expr(d.env);
-    for(i=0;i<n;i++)
+    int nnz = 0;
+    for(int k=0;k<cut.nnz;k++)
+        if(abs(cut.val[k])>EPS_CUT_COEFS){
+            batch.addCoef(cut.idx[k], cut.val[k]);
+            nnz++;
+        }
+    #ifndef NDEBUG
+    CPLOG("Sparse cut generated:");
+    for(int k=0;k<cut.nnz;k++)
+        CPLOG(cut.val[k]<<"*y["<<cut.idx[k]<<"]+");
+    CPLOG(((cut.sense==1)?"<=":((cut.sense==-1)?">=":"=="))<<cut.rHand<<endl);
+    #endif
+    double lhsMin = -infty, lhsMax = infty;
+    if(cut.sense!=-1)                  //<= or ==
+        lhsMax = cut.rHand;
+    if(cut.sense!=1)                   //>= or ==
+        lhsMin = cut.rHand;
+    batch.endRow(lhsMin, lhsMax);
+    return nnz;
+}
+//the dense counterpart for a cut coefs^T x <= rightHand, see modelAddCut(double*,double)
+static int denseCutToBatch(rowBatch& batch, int n, double* coefs, double rightHand, double infty,
+                           ostream& DEBUG_PARAM(cplog))
+{
+    int nnz = 0;
+    for(int i=0;i<n;i++)
         if(abs(coefs[i])>EPS_CUT_COEFS){
-            totalNrCoefs+=1;
-            expr+=coefs[i]* d.vars[i];
+            batch.addCoef(i, coefs[i]);
+            nnz++;
         }
-    #ifdef TMP_CUT_ERASER
-    if((!recordedConstr)&&(coefs[n-3]>0)&&(coefs[n-3]<1)){
-        recordedConstr = n-3;
-        d.rrecConstr = IloRange(expr<=rightHand);
-        d.model.add(d.rrecConstr);
-        expr.end();
-        assert(1==0);
-        return -1;
-    }
+    #ifndef NDEBUG
+    CPLOG("Cut Generated:");
+    for(int i=0;i<n;i++)
+        if(abs(coefs[i])>EPS_CUT_COEFS)
+            CPLOG(coefs[i]<<"*y["<<i<<"]+");
+    CPLOG("<="<<rightHand<<endl);
     #endif
+    batch.endRow(-infty, rightHand);
+    return nnz;
+}
+//All rows of the batch reach the solver in a single call, so that it synchronizes
+//(extracts) the new rows once per batch and not once per row
+//Return value: the id of the first new row
+static int commitBatch(lpBackend& lp, rowBatch& batch)
+{
+    int nr = batch.size();
+    vector<int>     nnz(nr);
+    vector<int*>    idx(nr);
+    vector<double*> val(nr);
+    for(int k=0;k<nr;k++){
+        nnz[k] = batch.start[k+1]-batch.start[k];
+        idx[k] = batch.idx.data()+batch.start[k];
+        val[k] = batch.val.data()+batch.start[k];
+    }
+    return lp.addRows(nr, nnz.data(), idx.data(), val.data(), batch.lhsMin.data(),
+                      batch.lhsMax.data());
+}
+//Append to out the rows of in violated by x. Return value: the number of rows appended
+static int keepViolatedRows(rowBatch& in, rowBatch& out, double* x)
+{
+    int kept = 0;
+    for(int k=0;k<in.size();k++){
+        double lhs = 0;
+        for(int j=in.start[k];j<in.start[k+1];j++)
+            lhs += in.val[j]*x[in.idx[j]];
+        if((lhs>=in.lhsMin[k]-EPS)&&(lhs<=in.lhsMax[k]+EPS))
+            continue;
+        for(int j=in.start[k];j<in.start[k+1];j++)
+            out.addCoef(in.idx[j], in.val[j]);
+        out.endRow(in.lhsMin[k], in.lhsMax[k]);
+        kept++;
+    }
+    return kept;
+}
+
+int CuttingPlanesEngine::modelAddCut(double * coefs, double rightHand)
+{
     ////TESTING A CERTAIN FEASIBLE PRIMAL IS REALLY FEASIBLE
     #ifdef TESTING_A_FEASIBLE_PRIMAL_zz
+       int i;
        double zSum=0;
        for(i=0;i<n;i++)
            if(abs(coefs[i])>EPS_CUT_COEFS)
@@ -432,41 +497,26 @@ int CuttingPlanesEngine::modelAddCut(double * coefs, double rightHand)
                }
        }
     #endif
-    CPLOG("Cut Generated:");
-    #ifndef NDEBUG
-    for(i=0;i<n;i++)
-        if(abs(coefs[i])>EPS_CUT_COEFS){
-                    CPLOG(coefs[i]<<"*y["<<i<<"]+");
-        }
-    CPLOG("<=");
-    CPLOG(rightHand<<endl);
-    #endif
-    d.cuts.add(expr<=rightHand);
+    rowBatch batch;
+    totalNrCoefs += denseCutToBatch(batch, n, coefs, rightHand, d.lp.lpInfinity(), cplog);
+    commitBatch(d.lp, batch);
     noRows++;
-    d.model.add(d.cuts[noRows-1]);
-    expr.end();    
     return noRows-1;
 }
 
 //Linux Kernel style: "macros resembling functions may be named in lower case"
 #define addCutWithSense(coefs,rightHand,sense)                                \
  do{                                                                            \
-   int i;                                                                       \
-   IloExpr expr(d.env);                                                         \
-   for(i=0;i<n;i++){                                                            \
-           expr+=coefs[i]* d.vars[i];                                           \
+   rowBatch batch;                                                              \
+   for(int i=0;i<n;i++){                                                        \
+           if(coefs[i]!=0)                                                      \
+               batch.addCoef(i, coefs[i]);                                      \
            totalNrCoefs++;                                                      \
    }                                                                            \
-   if(sense==1)                                                                 \
-       d.cuts.add(expr<=rightHand);                                             \
-   if(sense==0)                                                                 \
-       d.cuts.add(expr==rightHand);                                             \
-   if(sense==-1)                                                                \
-       d.cuts.add(expr>=rightHand);                                             \
-                                                                                \
+   double infty = d.lp.lpInfinity();                                            \
+   batch.endRow((sense==1) ? -infty : rightHand, (sense==-1) ? infty : rightHand);\
+   commitBatch(d.lp, batch);                                                    \
    noRows++;                                                                    \
-   d.model.add(d.cuts[noRows-1]);                                               \
-   expr.end();                                                                  \
    return noRows-1;                                                             \
   }while(false);
 
@@ -483,32 +533,226 @@ int CuttingPlanesEngine::modelAddEquality(int * coefs, double rightHand)
     addCutWithSense(coefs, rightHand,0);
 }
 
+//The row is built in one shot from the non-zeros, without scanning n positions
+int CuttingPlanesEngine::modelAddCut(const sparseCut& cut)
+{
+    rowBatch batch;
+    totalNrCoefs += sparseCutToBatch(batch, cut, d.lp.lpInfinity(), cplog);
+    commitBatch(d.lp, batch);
+    noRows++;
+    return noRows-1;
+}
+
+//With purgeable=1, the cuts of the round enter the cut pool management (see updateCutPool)
+//and their non-zeros are copied from the batch to their pool entries
+#define commitRoundBatch(batch,purgeable)                                             \
+  do{                                                                                 \
+    int firstId = commitBatch(d.lp, batch);                                           \
+    if(purgeable){                                                                    \
+        markPurgeable(firstId, batch.size());                                         \
+        for(int k=0;k<batch.size();k++){                                              \
+            cutPoolEntry& e = d.pool[firstId+k];                                      \
+            e.idx.assign(batch.idx.begin()+batch.start[k],                            \
+                         batch.idx.begin()+batch.start[k+1]);                         \
+            e.val.assign(batch.val.begin()+batch.start[k],                            \
+                         batch.val.begin()+batch.start[k+1]);                         \
+            e.lhsMin = batch.lhsMin[k];                                               \
+            e.lhsMax = batch.lhsMax[k];                                               \
+        }                                                                             \
+    }                                                                                 \
+    noRows += batch.size();                                                           \
+  }while(false);
+
+int CuttingPlanesEngine::modelAddCutRound(const sparseCut& cut, const sparseCut*cutsMore, int nrMore, 
+                                          int purgeable)
+{
+    double startTmInsert = getCPUTime();
+    int firstId = noRows;
+    double infty = d.lp.lpInfinity();
+    rowBatch batch;
+    totalNrCoefs += sparseCutToBatch(batch, cut, infty, cplog);
+    for(int i=0;i<nrMore;i++)
+        totalNrCoefs += sparseCutToBatch(batch, cutsMore[i], infty, cplog);
+    commitRoundBatch(batch, purgeable);
+    lastTmInsertCuts = getCPUTime()-startTmInsert;
+    tmInsertCuts    += lastTmInsertCuts;
+    return firstId;
+}
+int CuttingPlanesEngine::modelAddCutRound(double*coefs, double rightHand, double**coefsMore, 
+                                          double*rightHandsMore, int nrMore, int purgeable)
+{
+    double startTmInsert = getCPUTime();
+    int firstId = noRows;
+    double infty = d.lp.lpInfinity();
+    rowBatch batch;
+    totalNrCoefs += denseCutToBatch(batch, n, coefs, rightHand, infty, cplog);
+    for(int i=0;i<nrMore;i++)
+        totalNrCoefs += denseCutToBatch(batch, n, coefsMore[i], rightHandsMore[i], infty, cplog);
+    commitRoundBatch(batch, purgeable);
+    lastTmInsertCuts = getCPUTime()-startTmInsert;
+    tmInsertCuts    += lastTmInsertCuts;
+    return firstId;
+}
+int CuttingPlanesEngine::modelAddCuts(const sparseCut* cuts, int nr)
+{
+    if(nr<=0)
+        return -1;
+    return modelAddCutRound(cuts[0], cuts+1, nr-1, 0);
+}
+int CuttingPlanesEngine::modelAddCuts(double** coefs, double* rightHands, int nr)
+{
+    if(nr<=0)
+        return -1;
+    return modelAddCutRound(coefs[0], rightHands[0], coefs+1, rightHands+1, nr-1, 0);
+}
+double CuttingPlanesEngine::getTmInsertCuts()
+{
+    return tmInsertCuts;
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |         CUT POOL MANAGEMENT        |
+                         +-----------------------------------*/
+void CuttingPlanesEngine::activateCutPool(int maxAge)
+{
+    cutPoolMaxAge = maxAge;
+}
+void CuttingPlanesEngine::markPurgeable(int firstId, int nr)
+{
+    if((int)d.pool.size()<firstId+nr)
+        d.pool.resize(firstId+nr);
+    for(int i=firstId;i<firstId+nr;i++)
+        d.pool[i].purgeable = 1;
+}
+//Re-inject in the LP all pooled cuts violated by the current primals
+//Return value: the number of re-injected cuts
+int CuttingPlanesEngine::reinjectViolatedPoolCuts()
+{
+    if(cutPoolSize==0)
+        return 0;
+    int reinjected = 0;
+    for(int i=0;i<(int)d.pool.size();i++){
+        cutPoolEntry& e = d.pool[i];
+        if(e.inLP)
+            continue;
+        double lhs = 0;
+        for(int k=0;k<(int)e.idx.size();k++)
+            lhs += e.val[k]*primals[e.idx[k]];
+        if((lhs<e.lhsMin-EPS)||(lhs>e.lhsMax+EPS)){
+            d.lp.addRowBackToLP(i);
+            e.inLP = 1;
+            e.age  = 0;
+            reinjected++;
+        }
+    }
+    cutPoolSize       -= reinjected;
+    nrReactivatedCuts += reinjected;
+    return reinjected;
+}
+//Called after each successful master solve of runCutPlanes:
+// 1) re-inject violated pooled cuts and re-solve, until no pooled cut is violated
+// 2) age the purgeable cuts of the LP using their duals and move to the pool those with
+//    a zero dual for more than cutPoolMaxAge consecutive rounds
+//Return value: 0 if the master became infeasible during a re-solve, 1 otherwise
+int CuttingPlanesEngine::updateCutPool()
+{
+    if((cutPoolMaxAge<=0)||(intVars>0))         //no duals on a MIP
+        return 1;
+    while(reinjectViolatedPoolCuts()>0){
+        CPLOG("Re-solving after re-injecting pooled cuts (pool size "<<cutPoolSize<<")\n");
+        solve();
+        if((maximize)&&(ctx.upperBound==INT_MIN))
+            return 0;
+        if((!maximize)&&(ctx.lowerBound==INT_MAX))
+            return 0;
+    }
+    #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
+    if(suboptimal)                              //the duals are not reliable
+        return 1;
+    #endif
+    int purged = 0;
+    for(int i=0;i<(int)d.pool.size();i++){
+        cutPoolEntry& e = d.pool[i];
+        if((!e.purgeable)||(!e.inLP))
+            continue;
+        if(abs(d.lp.getDual(i))>EPS){
+            e.age = 0;
+            continue;
+        }
+        e.age++;
+        //with warm start, a row with a non-basic slack (degenerate) waits: taking it
+        //out of the LP would invalidate the basis reused by the next re-solve
+        if((e.age>cutPoolMaxAge)&&((!warmStart)||d.lp.rowSlackBasic(i))){
+            d.lp.removeRowFromLP(i);
+            e.inLP = 0;
+            purged++;
+        }
+    }
+    cutPoolSize  += purged;
+    nrPurgedCuts += purged;
+    if(purged>0)
+        CPLOG("Purged "<<purged<<" non-binding cuts, LP rows: "<<noRows-cutPoolSize<<", pool size: "
+              <<cutPoolSize<<", total purges: "<<nrPurgedCuts<<", re-activations: "<<nrReactivatedCuts<<endl);
+    return 1;
+}
+int CuttingPlanesEngine::getCutPoolSize()
+{
+    return cutPoolSize;
+}
+long CuttingPlanesEngine::getNrPurgedCuts()
+{
+    return nrPurgedCuts;
+}
+long CuttingPlanesEngine::getNrReactivatedCuts()
+{
+    return nrReactivatedCuts;
+}
+
 double CuttingPlanesEngine::getObjVal()
 {
     return currObj;
 }
+
+/*-----------------------+------------------------------------+--------------------------
+                         |    WARM START (BASIS REUSE)        |
+                         +-----------------------------------*/
+void CuttingPlanesEngine::activateWarmStart()
+{
+    warmStart = 1;
+    d.lp.setWarmStart(1);
+}
+long CuttingPlanesEngine::getNrSimplexIters()
+{
+    return nrSimplexIters;
+}
+long CuttingPlanesEngine::getLastNrSimplexIters()
+{
+    return lastNrSimplexIters;
+}
 //Linux Kernel style: "macros resembling functions may be named in lower case"
-#define randomizedSolve(cplex,model,vars,objCoefsCopy,env)                               \
+#define randomizedSolve(status,objCoefsCopy)                                             \
   do{                                                                                    \
-     IloObjective obj = cplex.getObjective();                                            \
-     IloExpr exprOrigObj(env);                                                           \
-     for(int i=0;i<n;i++)                                                                \
-          exprOrigObj=exprOrigObj+objCoefsCopy[i]*vars[i];                               \
-     IloConstraint objKeepFixed = (exprOrigObj==cplex.getObjValue());                    \
-     /*cout<<setprecision(12)<<cplex.getObjValue()<<endl;*/                              \
-     for(int i=0;i<n;i++)                                                                \
-          obj.setLinearCoef(vars[i],rand()%100);                                          \
-     model.add(objKeepFixed);                                                            \
-     cplex.solve();                                                                      \
-     model.remove(objKeepFixed);                                                         \
+     double* rndCoefs = new double[n];                                                   \
      for(int i=0;i<n;i++)                                                                \
-          obj.setLinearCoef(vars[i],objCoefsCopy[i]);                                    \
-     exprOrigObj.end();                                                                  \
-     objKeepFixed.end();                                                                 \
-     cplex.solve();                                                                      \
+          rndCoefs[i] = rand()%100;                                                      \
+     status = d.lp.solveWithObjFixed(objCoefsCopy, rndCoefs);                            \
+     delete[] rndCoefs;                                                                  \
    }while(false);                                                                        \
 
-//set ::lowerBound = INT_MAX (when minimizing) resp INT_MIN (when maximizing) if error 
+//In pipelined mode (see activatePipelining), a separator may read the bounds while solve()
+//runs: the new bound is kept in pendingBound and runCutPlanes publishes it after the join
+#define setMasterBound(val)                                                           \
+  do{                                                                                 \
+    if(deferBounds){                                                                  \
+        pendingBound = (val);                                                         \
+        boundPending = 1;                                                             \
+    }else if(maximize)                                                                \
+        ctx.upperBound = (val);                                                       \
+    else                                                                              \
+        ctx.lowerBound = (val);                                                       \
+  }while(false);
+
+//set ctx.lowerBound = INT_MAX (when minimizing) resp INT_MIN (when maximizing) if error 
 //because (not enough time as set by setTimeoutSolve())
 double CuttingPlanesEngine::solve()
 {
@@ -516,126 +760,112 @@ double CuttingPlanesEngine::solve()
     #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
     suboptimal = 0;
     #endif
-    try{
-        double startTmSolve = getCPUTime();
-        //Does not work on LPs, but mainly on ILPS
-        //d.cplex.setParam(IloCplex::Param::RandomSeed, 62);
-        d.cplex.solve();
-        #ifdef RANDOMIZE_MASTER_SOLVE
-            d.itersRandomized++;
-            if(d.itersRandomized<10)       //enough to randomized first 10
-            if(d.objCoefsCopy!=NULL)
-                randomizedSolve(d.cplex,d.model,d.vars,d.objCoefsCopy,d.env);
-        #endif
-
-        tmOnlySolve+=(getCPUTime()-startTmSolve);
-        objVal = d.cplex.getObjValue();   //Extract solution
-        //CPLOG("Cut Planes objVal="<<objVal<<endl);
-        //CPLOG("Status:"<<d.cplex.getCplexStatus()<<endl);
-        //if(d.cplex.getCplexStatus() ==IloCplex::AbortTimeLim) CPLOG("Time limit\n");
-        if(d.cplex.getCplexStatus() ==IloCplex::AbortTimeLim){
-            #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
-            if(timeoutSet!=-1){//-1 means disabled
-            #endif
-                 cerr<<"\n\n\nATTENTION: time limit "<<timeoutSet<<" secs exceeded in ConstrGener. I will report this and\n\
-                       and probably stop afterwords. Did you use setTimeoutSolve()?\n\n";
-                 if(maximize){
-                    ::upperBound = INT_MIN;
-                    currObj      = INT_MIN;
-                    return  INT_MIN;
-                 }else{
-                    ::lowerBound = INT_MAX;
-                    currObj      = INT_MAX;
-                    return  INT_MAX;
-                 }
-            #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
+    double startTmSolve = getCPUTime();
+    int status = d.lp.solve();
+    lastNrSimplexIters = d.lp.getNrIters();
+    #ifdef RANDOMIZE_MASTER_SOLVE
+        d.itersRandomized++;
+        if(status==LP_OPTIMAL)
+        if(d.itersRandomized<10)       //enough to randomized first 10
+        if(d.objCoefsCopy!=NULL){
+            if(warmStart&&(intVars==0))
+                d.lp.saveBasis();
+            randomizedSolve(status,d.objCoefsCopy);
+            lastNrSimplexIters += d.lp.getNrIters();
+            if(warmStart&&(intVars==0)&&(status!=LP_OPTIMAL)){
+                //back to the optimal basis found before randomizing: 0 pivots
+                d.lp.restoreBasis();
+                status = d.lp.solve();
+                lastNrSimplexIters += d.lp.getNrIters();
             }
-            CPLOG("\n\n\nATTENTION: macro TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS activated in Cutting Planes \n\
-                       Its value is "<<TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS<<"s. The objVal is "<<objVal<<" Explanation:\n\
-                       It is the number of seconds before stopping a call to solve() and take\n\
-                       the current non-optimal solution. The cutting-planes can continue\n\
-                       and maybe even the current non-optimal solution can be cut.\n\
-                       Otherwise, I will multiply this timeout by 100 and try a full solve.\n\
-                       If it fails, I'll stop. For the moment I report the primals to cutSeprt,\n\
-                       I set suboptimal=1 and don't update the lower bound"<<::lowerBound<<"\n");
-            if(maximize)
-                objVal = INT_MIN+1;
-            else
-                objVal = INT_MAX-1;
-            IloNumArray solution(d.env);
-            d.cplex.getValues (d.vars,solution);
-            for(int i=0;i<n;i++)
-                primals[i] = solution[i];
-            suboptimal = 1;
-            return currObj;//old lower bound, I don't update it when suboptimal
-            #endif     /*TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS*/
         }
-    }catch (IloCplex::Exception e){
-        if(d.cplex.getStatus()==IloAlgorithm::InfeasibleOrUnbounded){
-            cerr<<"Attention: InfeasibleOrUnbounded. Last time I had this error, it was because\n \
-                   the program you served me was infeasible, it was not possible to find the \n \
-                   configurations that do satisfy all set-covering constraints\n\
-                   You can think of temporarily adding the 1 1 1 ... 1 columns with cost INT_MAX\n\
-                   Later, you can erase it with modelDelCut(i) where i is the return value of \n\
-                   the call modelAddCut for the above temporarily column. You do this when \n\
-                   this column reaches a dual value of 0, via getCutCoefSol(...)\n\
-                   Model saved to trycatch.lp";
-            cerr<<"I do not call exit but set currObj=INT_MAX, because this situation might be normal. You should check this.\n"; 
-            d.cplex.exportModel("trycatch.lp");
-            if(maximize){
-                objVal = INT_MIN;
-                ::upperBound = INT_MIN;
-                currObj = INT_MIN;
-            }else{
-                objVal = INT_MAX;
-                ::lowerBound = INT_MAX;
-                currObj = INT_MAX;
-            }
+    #endif
+    if(warmStart&&(intVars==0)&&(status==LP_OPTIMAL))
+        d.lp.saveBasis();              //a MIP has no basis
+    nrSimplexIters += lastNrSimplexIters;
+    tmOnlySolve+=(getCPUTime()-startTmSolve);
+    //CPLOG("Cut Planes objVal="<<objVal<<endl);
+    //CPLOG("Status:"<<status<<endl);
+    if(status==LP_TIME_LIMIT){
+        #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
+        if(timeoutSet!=-1){//-1 means disabled
+        #endif
+             cerr<<"\n\n\nATTENTION: time limit "<<timeoutSet<<" secs exceeded in ConstrGener. I will report this and\n\
+                   and probably stop afterwords. Did you use setTimeoutSolve()?\n\n";
+             if(maximize){
+                setMasterBound(INT_MIN);
+                currObj      = INT_MIN;
+                return  INT_MIN;
+             }else{
+                setMasterBound(INT_MAX);
+                currObj      = INT_MAX;
+                return  INT_MAX;
+             }
+        #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
         }
+        CPLOG("\n\n\nATTENTION: macro TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS activated in Cutting Planes \n\
+                   Its value is "<<TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS<<"s. Explanation:\n\
+                   It is the number of seconds before stopping a call to solve() and take\n\
+                   the current non-optimal solution. The cutting-planes can continue\n\
+                   and maybe even the current non-optimal solution can be cut.\n\
+                   Otherwise, I will multiply this timeout by 100 and try a full solve.\n\
+                   If it fails, I'll stop. For the moment I report the primals to cutSeprt,\n\
+                   I set suboptimal=1 and don't update the lower bound"<<ctx.lowerBound<<"\n");
+        d.lp.getPrimals(primals);
+        suboptimal = 1;
+        return currObj;//old lower bound, I don't update it when suboptimal
+        #endif     /*TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS*/
+    }
+    if(status==LP_INFEAS_OR_UNBOUNDED){
+        cerr<<"Attention: InfeasibleOrUnbounded. Last time I had this error, it was because\n \
+               the program you served me was infeasible, it was not possible to find the \n \
+               configurations that do satisfy all set-covering constraints\n\
+               You can think of temporarily adding the 1 1 1 ... 1 columns with cost INT_MAX\n\
+               Later, you can erase it with modelDelCut(i) where i is the return value of \n\
+               the call modelAddCut for the above temporarily column. You do this when \n\
+               this column reaches a dual value of 0, via getCutCoefSol(...)\n\
+               Model saved to trycatch.lp";
     }
-    if(d.cplex.getStatus()==IloAlgorithm::Infeasible){
-        d.cplex.exportModel("trycatch.lp");
+    if(status==LP_INFEASIBLE)
         cerr<<"ATTENTION on Cutting-Planes: finding infeasible solution.  Model saved to trycatch.lp. \n";
-        cerr<<"I do not call exit but set currObj=INT_MAX, because this situation might be normal.  You should check this.\n"; 
+    if((status==LP_INFEAS_OR_UNBOUNDED)||(status==LP_INFEASIBLE)){
+        cerr<<"I do not call exit but set currObj=INT_MAX, because this situation might be normal. You should check this.\n"; 
+        d.lp.exportModel("trycatch.lp");
         if(maximize){
-            objVal = INT_MIN;
-            ::upperBound = INT_MIN;
+            setMasterBound(INT_MIN);
             currObj = INT_MIN;
         }else{
-            objVal = INT_MAX;
-            ::lowerBound = INT_MAX;
+            setMasterBound(INT_MAX);
             currObj = INT_MAX;
         }
+        return currObj;
     }
 
-    IloNumArray solution(d.env);
-    d.cplex.getValues (d.vars,solution);
+    objVal = d.lp.getObjVal();        //Extract solution
+    d.lp.getPrimals(primals);
     for(int i=0;i<n;i++){
-            primals[i] = solution[i];
             //CPLOG(primals[i]<<",");
-            //assert(primals[i]>=d.lb[i]);
-            //assert(d.lb[i]==0);
             //use below if you don't set NumericalEmphasis true
-            if(lowerBound!=INT_MAX)           //if still feasible
-            if(!(primals[i]>=d.lb[i]-EPS)){
+            if(maximize||(currObj!=INT_MAX))  //if still feasible
+            if(!(primals[i]>=d.lp.getVarLB(i)-EPS)){
                 cout<<"wrong i="<<i<<endl;
-                cout<<primals[i]<<" "<<d.lb[i]<<endl;
+                cout<<primals[i]<<" "<<d.lp.getVarLB(i)<<endl;
                 exit(1);
             }
             //rounding the primals to the correct values
-            //if(primals[i]<d.lb[i]+EPS)primals[i]=d.lb[i];
+            //if(primals[i]<d.lp.getVarLB(i)+EPS)primals[i]=d.lp.getVarLB(i);
     }
     //CPLOG("\n");
     
     if(maximize){
         if(objVal<currObj){                    //Update bound
             currObj      = objVal;
-            ::upperBound = objVal;
+            setMasterBound(objVal);
         }
     }else{
         if(objVal>currObj){                    //Update bound
             currObj = objVal;
-            ::lowerBound = objVal;
+            setMasterBound(objVal);
         }
     }
     return currObj;
@@ -650,26 +880,18 @@ void CuttingPlanesEngine::getPrimals(double *ystar)
 
 void CuttingPlanesEngine::setPrimals(double *startPrimals, double objValInit)
 {
-     IloNumArray startValues(d.env);
-     IloNumVarArray varCpy(d.env);
      if(maximize)
-        upperBound = objValInit;
+        ctx.upperBound = objValInit;
      else
-        lowerBound = objValInit;
-     for (int i = 0; i < n; ++i){
-             startValues.add(startPrimals[i]);
-             varCpy.add(d.vars[i]);
+        ctx.lowerBound = objValInit;
+     for (int i = 0; i < n; ++i)
              primals[i] = startPrimals[i];
-     }
      try{
-        //d.cplex.addMIPStart(varCpy, startValues);
-        d.cplex.setStart(startValues,NULL,varCpy,NULL,NULL,NULL);
-     }catch (IloCplex::Exception e){
-        cerr<<"\n\nConcert Exception in when setting initial values for variables:"<<e.getMessage()<<endl;
+        d.lp.setStart(startPrimals);
+     }catch (lpBackendError e){
+        cerr<<"\n\nLP solver error when setting initial values for variables:"<<e.getMessage()<<endl;
         exit(EXIT_FAILURE);
      }
-     varCpy.end();
-     startValues.end();
      primalsSetByUser = 1;
 }
 
@@ -698,7 +920,7 @@ int CuttingPlanesEngine::violatedCut(int * coefs, double rightHand)
 }
 void CuttingPlanesEngine::exportModel(char* filename)
 {
-    d.cplex.exportModel(filename);
+    d.lp.exportModel(filename);
 }
 void CuttingPlanesEngine::freeData(double*&a,double*&b, double**&c,int nr)
 {
@@ -712,65 +934,278 @@ void CuttingPlanesEngine::freeData(double*&a,double*&b, double**&c,int nr)
     }
 }
 
+sparseCut* CuttingPlanesEngine::newSparseCuts(int nr)
+{
+    sparseCut* cuts = new sparseCut[nr];
+    for(int i=0;i<nr;i++){
+        cuts[i].nnz   = 0;
+        cuts[i].idx   = new int[n];
+        cuts[i].val   = new double[n];
+        cuts[i].rHand = 0;
+        cuts[i].sense = 1;
+    }
+    return cuts;
+}
+void CuttingPlanesEngine::freeSparseCuts(sparseCut*&cuts, int nr)
+{
+    if(cuts==NULL)
+        return;
+    for(int i=0;i<nr;i++){
+        delete[] cuts[i].idx;
+        delete[] cuts[i].val;
+    }
+    delete[] cuts;
+    cuts = NULL;
+}
+
 double CuttingPlanesEngine::runSelectedCutSeprt(const int n, double*primals, double * newCut,double&newRightHand,
                                      int it, double tm, double ** newCutMore,double*newRightHandMore,
                                      int&newMore, int maxMoreConstr)
 {
       if(internalCutSeprtExtended!=NULL)
            return internalCutSeprtExtended(n,primals,newCut, newRightHand,it,tm,
-                                   newCutMore,newRightHandMore,newMore, maxMoreConstr);
+                                   newCutMore,newRightHandMore,newMore, maxMoreConstr,ctx);
       if(internalCutSeprtSolver!=NULL)
-           return internalCutSeprtSolver(n,primals,newCut, newRightHand,it,tm);
-      return internalCutSeprtSimple(n,primals,newCut, newRightHand);
+           return internalCutSeprtSolver(n,primals,newCut, newRightHand,it,tm,ctx);
+      return internalCutSeprtSimple(n,primals,newCut, newRightHand,ctx);
 } 
+double CuttingPlanesEngine::runSelectedCutSeprt(const int n, double*primals, sparseCut&newCut,
+                                     int it, double tm, sparseCut*newCutMore, int&newMore,
+                                     int maxMoreConstr)
+{
+      return internalCutSeprtSparse(n,primals,newCut,it,tm,newCutMore,newMore,maxMoreConstr,ctx);
+}
+void CuttingPlanesEngine::activatePipelining()
+{
+    pipelined = 1;
+}
+long CuttingPlanesEngine::getNrStaleCuts()
+{
+    return nrStaleCuts;
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |             TELEMETRY              |
+                         +-----------------------------------*/
+void CuttingPlanesEngine::setIterStatsCallback(iterStatsCallback_t cb, void* userData)
+{
+    statsCallback = cb;
+    statsUserData = userData;
+}
+void CuttingPlanesEngine::writeIterStats(ostream& out, int format)
+{
+    statsOut    = &out;
+    statsFormat = format;
+    if(format==ITER_STATS_CSV)
+        out<<"it,cpuTm,wallTm,solveCpuTm,solveWallTm,sepCpuTm,sepWallTm,overlapSepWallTm,"
+             "nrCutsAdded,totalNrCoefs,lpRows,objVal,lowerBound,upperBound,simplexIters"<<endl;
+}
+void CuttingPlanesEngine::emitIterStats(const iterStats& st)
+{
+    if(statsCallback!=NULL)
+        statsCallback(st, statsUserData);
+    if(statsOut==NULL)
+        return;
+    ostream& out = *statsOut;
+    streamsize oldPrecision = out.precision(12);
+    if(statsFormat==ITER_STATS_CSV)
+        out<<st.it<<","<<st.cpuTm<<","<<st.wallTm<<","<<st.solveCpuTm<<","<<st.solveWallTm
+           <<","<<st.sepCpuTm<<","<<st.sepWallTm<<","<<st.overlapSepWallTm<<","
+           <<st.nrCutsAdded<<","<<st.totalNrCoefs<<","<<st.lpRows<<","<<st.objVal<<","
+           <<st.lowerBound<<","<<st.upperBound<<","<<st.simplexIters<<endl;
+    else
+        out<<"{\"it\":"<<st.it<<",\"cpuTm\":"<<st.cpuTm<<",\"wallTm\":"<<st.wallTm
+           <<",\"solveCpuTm\":"<<st.solveCpuTm<<",\"solveWallTm\":"<<st.solveWallTm
+           <<",\"sepCpuTm\":"<<st.sepCpuTm<<",\"sepWallTm\":"<<st.sepWallTm
+           <<",\"overlapSepWallTm\":"<<st.overlapSepWallTm
+           <<",\"nrCutsAdded\":"<<st.nrCutsAdded<<",\"totalNrCoefs\":"<<st.totalNrCoefs
+           <<",\"lpRows\":"<<st.lpRows<<",\"objVal\":"<<st.objVal
+           <<",\"lowerBound\":"<<st.lowerBound<<",\"upperBound\":"<<st.upperBound
+           <<",\"simplexIters\":"<<st.simplexIters<<"}"<<endl;
+    out.precision(oldPrecision);
+}
+
 void CuttingPlanesEngine::setTimeoutSolve(double timeOut)
 {
-        //before enforcing time limits, you may need call below to be sure cplex
-        //thinks in terms of CPU time and not Wall Time which includes dead moments
-        //d.cplex.setParam(IloCplex::Param::ClockType,1);
-        d.cplex.setParam(TIME_LIMIT_PARAM,timeOut);
+        d.lp.setTimeLimit(timeOut);
         timeoutSet = timeOut;
 }
 
+//Linux Kernel style: "macros resembling functions may be named in lower case"
+//Below macros use the local cut buffers of runCutPlanes
+//All cuts of the round are inserted in one batch, see modelAddCutRound()
+#define addSeparatedCuts()                                                            \
+  do{                                                                                 \
+    if(internalCutSeprtSparse!=NULL)                                                  \
+         modelAddCutRound(spCut[0], spCutMore, newMore, 1);                           \
+    else if(internalCutSeprtExtended!=NULL)                                           \
+         modelAddCutRound(newCut,newRightHand,newCutMore,newRightHandMore,newMore,1); \
+    else                                                                              \
+         modelAddCutRound(newCut, newRightHand, NULL, NULL, 0, 1);                    \
+    CPLOG("Round insertion of "<<1+newMore<<" cut(s) took "<<lastTmInsertCuts        \
+          <<" secs (total "<<tmInsertCuts<<")"<<endl);                                \
+  }while(false);
+#define allocCutData(newCut,newCutMore,newRightHandMore,spCut,spCutMore)              \
+  do{                                                                                 \
+    if(internalCutSeprtSparse!=NULL){                                                 \
+        spCut     = newSparseCuts(1);                                                 \
+        spCutMore = newSparseCuts(maxMoreConstr);                                     \
+    }else                                                                             \
+        newCut    = new double[n];                                                    \
+    if(internalCutSeprtExtended!=NULL){                                               \
+        newCutMore = new double*[maxMoreConstr];                                      \
+        newRightHandMore = new double[maxMoreConstr];                                 \
+        for(int iii=0;iii<maxMoreConstr;iii++)                                        \
+             newCutMore[iii] = new double[n];                                         \
+    }                                                                                 \
+  }while(false);
+#define freeAllCutData()                                                              \
+  do{                                                                                 \
+    freeData(newCut,newRightHandMore,newCutMore,maxMoreConstr);                       \
+    freeSparseCuts(spCut,1);                                                          \
+    freeSparseCuts(spCutMore,maxMoreConstr);                                          \
+    if(pipelined){                                                                    \
+        freeData(wCut,wRightHandMore,wCutMore,maxMoreConstr);                         \
+        freeSparseCuts(wSpCut,1);                                                     \
+        freeSparseCuts(wSpCutMore,maxMoreConstr);                                     \
+        delete[] stalePrimals;                                                        \
+    }                                                                                 \
+  }while(false);
+//Pipelined mode: re-solve the master while a worker thread separates the primals of the
+//previous solve (stalePrimals) using the w... buffers. The cuts it finds that are still
+//violated by the new primals go to staleCuts and they are fed to the next round
+#define solveWhileSeparating()                                                        \
+  do{                                                                                 \
+    for(int i=0;i<n;i++)                                                              \
+        stalePrimals[i] = primals[i];                                                 \
+    double staleViolation = 0;                                                        \
+    const char* staleErr  = NULL;                                                     \
+    deferBounds = 1;                                                                  \
+    std::thread worker([&]{                                                           \
+        double startWallSep = getWallTime();                                          \
+        try{                                                                          \
+            if(internalCutSeprtSparse!=NULL)                                          \
+                staleViolation = runSelectedCutSeprt(n,stalePrimals,wSpCut[0],it,tm,  \
+                                     wSpCutMore, wMore, maxMoreConstr);               \
+            else                                                                      \
+                staleViolation = runSelectedCutSeprt(n,stalePrimals,wCut,wRightHand,  \
+                                     it,tm,wCutMore,wRightHandMore,wMore,maxMoreConstr);\
+        }catch (lpBackendError e){                                                    \
+            staleErr = e.getMessage();                                                \
+        }                                                                             \
+        stats.overlapSepWallTm = getWallTime() - startWallSep;                        \
+    });                                                                               \
+    try{                                                                              \
+        solve();                                                                      \
+    }catch (lpBackendError e){                                                        \
+        worker.join();                                                                \
+        deferBounds = 0;                                                              \
+        throw;                                                                        \
+    }                                                                                 \
+    worker.join();                                                                    \
+    deferBounds = 0;                                                                  \
+    if(boundPending){                                                                 \
+        setMasterBound(pendingBound);                                                 \
+        boundPending = 0;                                                             \
+    }                                                                                 \
+    if(staleErr!=NULL)                                                                \
+        throw lpBackendError(staleErr);                                               \
+    if(staleViolation==INT_MAX){               /*gap closed*/                         \
+        /*the pooled cuts are checked at the primals of this round, and those     */ \
+        /*re-injected are solved again before the pool ages, as after solve()     */ \
+        int poolOk = updateCutPool();                                                 \
+        it++;                                                                         \
+        freeAllCutData();                                                             \
+        tm = getCPUTime() - startTm;                                                  \
+        if(!poolOk){                                                                  \
+            cerr<<"\n\n\nATTENTION: THE LP BECOME INFEASIBLE AFTER RE-INJECTING POOLED CUTS. STOP HERE\n";\
+            return EXIT_FAILURE;                                                      \
+        }                                                                             \
+        return EXIT_SUCCESS;                                                          \
+    }                                                                                 \
+    if(staleViolation<-EPS){                                                          \
+        rowBatch raw;                                                                 \
+        double infty = d.lp.lpInfinity();                                             \
+        if(internalCutSeprtSparse!=NULL){                                             \
+            sparseCutToBatch(raw, wSpCut[0], infty, cplog);                           \
+            for(int i=0;i<wMore;i++)                                                  \
+                sparseCutToBatch(raw, wSpCutMore[i], infty, cplog);                   \
+        }else{                                                                        \
+            denseCutToBatch(raw, n, wCut, wRightHand, infty, cplog);                  \
+            for(int i=0;(internalCutSeprtExtended!=NULL)&&(i<wMore);i++)              \
+                denseCutToBatch(raw, n, wCutMore[i], wRightHandMore[i], infty, cplog);\
+        }                                                                             \
+        int kept = keepViolatedRows(raw, staleCuts, primals);                         \
+        CPLOG("Pipelined separation: "<<kept<<" of "<<raw.size()                      \
+              <<" stale cut(s) still violated"<<endl);                                \
+    }                                                                                 \
+  }while(false);
+//Insert the stale cuts of the previous solveWhileSeparating() in one batch
+#define addStaleCuts()                                                                \
+  do{                                                                                 \
+    double startTmInsert = getCPUTime();                                              \
+    totalNrCoefs += staleCuts.idx.size();                                             \
+    nrStaleCuts  += staleCuts.size();                                                 \
+    commitRoundBatch(staleCuts, 1);                                                   \
+    lastTmInsertCuts = getCPUTime()-startTmInsert;                                    \
+    tmInsertCuts    += lastTmInsertCuts;                                              \
+    CPLOG("Round insertion of "<<staleCuts.size()<<" stale cut(s) took "             \
+          <<lastTmInsertCuts<<" secs (total "<<tmInsertCuts<<")"<<endl);              \
+    staleCuts.clear();                                                                \
+  }while(false);
+
 int CuttingPlanesEngine::runCutPlanes(const int itMax, const double tmMax, int& it, double&tm)
 {
         #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
         if(timeoutSet==-1){//user defined timeout has priority
-            //before enforcing time limits, you may need call below to be sure cplex
-            //thinks in terms of CPU time and not Wall Time which includes dead moments
-            //d.cplex.setParam(IloCplex::Param::ClockType,1);
-            d.cplex.setParam(TIME_LIMIT_PARAM,TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS);
+            d.lp.setTimeLimit(TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS);
         }
         #endif
   try{
        it = 0;
        tm = 0;
        double newRightHand, newViolation,startTm = getCPUTime();
-       double* newCut = new double[n];
-   
+       double startWallTm = getWallTime();
+       iterStats stats;                   //telemetry of the current iteration
+       double* newCut = NULL;             //dense cut buffers, not used by a cutSeprtSparse
        double** newCutMore = NULL;        //not necessarily used 
        double* newRightHandMore=NULL;     //only for cutSeprtExtended
-       int newMore;
-       if(internalCutSeprtExtended!=NULL){
-           newCutMore = new double*[maxMoreConstr];
-           newRightHandMore = new double[maxMoreConstr];
-           int iii;
-           for(iii=0;iii<maxMoreConstr;iii++)
-                newCutMore[iii] = new double[n];
+       sparseCut* spCut     = NULL;       //only for cutSeprtSparse
+       sparseCut* spCutMore = NULL;
+       int newMore = 0;
+       allocCutData(newCut,newCutMore,newRightHandMore,spCut,spCutMore);
+       //Below: the buffers of the worker thread in pipelined mode, see solveWhileSeparating
+       double wRightHand = 0, *wCut = NULL, **wCutMore = NULL, *wRightHandMore = NULL;
+       sparseCut *wSpCut = NULL, *wSpCutMore = NULL;
+       int wMore = 0;
+       double* stalePrimals = NULL;
+       rowBatch staleCuts;                //violated cuts separated on the previous primals
+       if(pipelined){
+           allocCutData(wCut,wCutMore,wRightHandMore,wSpCut,wSpCutMore);
+           stalePrimals = new double[n];
        }
 
-       //if(!d.cplex.isDualFeasible())                        //if unbounded
-       //    setVarBounds(-IloInfinity,INT_MAX/((double)n));  //Add some bounds on the variables
 
        if(!primalsSetByUser)
           solve();
        primalsSetByUser = 0;
+       long itStartSimplexIters = nrSimplexIters;
        do{
+           stats.sepCpuTm         = getCPUTime();
+           stats.sepWallTm        = getWallTime();
+           stats.overlapSepWallTm = 0;
            try{
-               newViolation = runSelectedCutSeprt(n,primals,newCut, newRightHand,it,tm,
+               //stale cuts still violated: the current primals are cut without separating
+               if(staleCuts.size()>0)
+                   newViolation = -1;
+               else if(internalCutSeprtSparse!=NULL)
+                   newViolation = runSelectedCutSeprt(n,primals,spCut[0],it,tm,
+                                    spCutMore, newMore, maxMoreConstr);
+               else
+                   newViolation = runSelectedCutSeprt(n,primals,newCut, newRightHand,it,tm,
                                     newCutMore,newRightHandMore, newMore, maxMoreConstr);
                if(newViolation==INT_MAX){//gap closed
-                     freeData(newCut,newRightHandMore,newCutMore,maxMoreConstr);
+                     freeAllCutData();
                      tm = getCPUTime() - startTm;
                      return EXIT_SUCCESS;
                }
@@ -780,17 +1215,17 @@ int CuttingPlanesEngine::runCutPlanes(const int itMax, const double tmMax, int&
                     CPLOG("If this is negative, the suboptimal solution is anyway cut and I go on normally\n\n");
                }
                #endif 
-           }catch (IloCplex::Exception e){
-                cerr<<"\n\nConcert Exception in your cutSeprt called by the Cutting-Planes:"<<e.getMessage()<<endl;
+           }catch (lpBackendError e){
+                cerr<<"\n\nLP solver error in your cutSeprt called by the Cutting-Planes:"<<e.getMessage()<<endl;
                 cerr<<"I do not call exit, because this might be normal.  You should know better, maybe catch the exception in your cutSeprt.\n\n\n"; 
                 if(maximize){
-                    ::upperBound = INT_MIN;
+                    ctx.upperBound = INT_MIN;
                     currObj = INT_MIN;
                 }else{
-                    ::lowerBound = INT_MAX;
+                    ctx.lowerBound = INT_MAX;
                     currObj = INT_MAX;
                 }
-                freeData(newCut,newRightHandMore,newCutMore,maxMoreConstr);
+                freeAllCutData();
                 tm = getCPUTime() - startTm;
                 return EXIT_FAILURE;
            }
@@ -801,39 +1236,34 @@ int CuttingPlanesEngine::runCutPlanes(const int itMax, const double tmMax, int&
                if(suboptimal){
                     CPLOG("Could not cut current suboptimal solution\n");
                     CPLOG("Adding generated cuts anyways\n");
-                    modelAddCut(newCut,newRightHand);
-                    if(internalCutSeprtExtended!=NULL){
-                         int ii;
-                         for(ii=0;ii<newMore;ii++)
-                             modelAddCut(newCutMore[ii], newRightHandMore[ii]);
-                    }
+                    addSeparatedCuts();
                     CPLOG("Allowing 100 times more time, i.e., "<<100*TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS<<" seconds.\n");
-                    d.cplex.setParam(TIME_LIMIT_PARAM,100*TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS);
+                    d.lp.setTimeLimit(100*TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS);
                     solve();
                     it++;
                     if(suboptimal){
                         cerr<<"Even after allowing 100 times more time, Cutting-Planes  can not finish solve. return INFEASIBLE ";
                         cerr<<"It could be possible to use CPX_PARAM_OBJLLIM to try to gain at least one\n";
-                        freeData(newCut,newRightHandMore,newCutMore,maxMoreConstr);
+                        freeAllCutData();
                         tm = getCPUTime() - startTm;
                         return EXIT_FAILURE;
                     }
                     if(maximize)
-                    if(::upperBound==INT_MAX){//solve sets ::upperBound=INT_MAX if infeasible
+                    if(ctx.upperBound==INT_MAX){//solve sets ctx.upperBound=INT_MAX if infeasible
                         cerr<<"\n\n I DID try 100 times more time. Quite strange finding infeasibility here.";
                         cerr<<"\nATTENTION: THE CONSTRAINT/COL GENERATOR LP BECOME INFEASIBLE. STOP HERE\n \
                                 without calling exit because this situation might be normal. Check it. \n\n\n";
                         break;
                     }
                     if(!maximize)
-                    if(::lowerBound==INT_MAX){//solve sets ::lowerBound=INT_MAX if infeasible
+                    if(ctx.lowerBound==INT_MAX){//solve sets ctx.lowerBound=INT_MAX if infeasible
                         cerr<<"\n\n I DID try 100 times more time. Quite strange finding infeasibility here.";
                         cerr<<"\nATTENTION: THE CONSTRAINT/COL GENERATOR LP BECOME INFEASIBLE. STOP HERE\n \
                                 without calling exit because this situation might be normal. Check it. \n\n\n";
                         break;
                     }
                     CPLOG("It seems I could solve it. Hope everything goes back to normal\n");
-                    d.cplex.setParam(TIME_LIMIT_PARAM,TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS);
+                    d.lp.setTimeLimit(TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS);
                     continue;
                }
                else//not suboptimal, but classical case
@@ -841,52 +1271,84 @@ int CuttingPlanesEngine::runCutPlanes(const int itMax, const double tmMax, int&
                {
                  if(turnIntegerEnd){
                      if(intVars==n){           //all integer => exit
-                          freeData(newCut,newRightHandMore,newCutMore,maxMoreConstr);
+                          freeAllCutData();
                           tm = getCPUTime() - startTm;
                           return EXIT_SUCCESS;
                      }
                      turnAllVarsInteger();
                  }else{
-                      freeData(newCut,newRightHandMore,newCutMore,maxMoreConstr);
+                      freeAllCutData();
                       tm = getCPUTime() - startTm;
                       it ++;
                       return EXIT_SUCCESS;
                  }
                }
            }
-           modelAddCut(newCut,newRightHand);
-           if(internalCutSeprtExtended!=NULL){
-                int ii;
-                for(ii=0;ii<newMore;ii++)
-                    modelAddCut(newCutMore[ii], newRightHandMore[ii]);
+           if(staleCuts.size()>0){
+                stats.sepCpuTm  = 0;
+                stats.sepWallTm = 0;
+           }else{
+                stats.sepCpuTm  = getCPUTime() - stats.sepCpuTm;
+                stats.sepWallTm = getWallTime() - stats.sepWallTm;
            }
-           if(::switchToIntVarsNow)  //the cutSeprt can set this global variable,
+           stats.nrCutsAdded = noRows;
+           if(staleCuts.size()>0)
+                addStaleCuts()
+           else
+                addSeparatedCuts();
+           stats.nrCutsAdded = noRows - stats.nrCutsAdded;
+           stats.solveCpuTm  = tmOnlySolve;
+           stats.solveWallTm = getWallTime();
+           if(ctx.switchToIntVarsNow)  //the cutSeprt can set this in its context,
                 turnAllVarsInteger();//but it can't call turnAllVarsInteger() directly
-           solve();
+           if(pipelined&&(intVars==0))
+                solveWhileSeparating()
+           else
+                solve();
            if(maximize)
-           if(::upperBound==INT_MAX){//solve sets ::upperBound=INT_MAX if infeasible
+           if(ctx.upperBound==INT_MAX){//solve sets ctx.upperBound=INT_MAX if infeasible
                 cerr<<"\n\n\nATTENTION: THE CONSTRAINT/COL GENERATOR LP BECOME INFEASIBLE. STOP HERE\n \
                        without calling exit because this situation might be normal. Check it. \n\n\n";
                 break;
            }
            if(!maximize)
-           if(::lowerBound==INT_MAX){//solve sets ::lowerBound=INT_MAX if infeasible
+           if(ctx.lowerBound==INT_MAX){//solve sets ctx.lowerBound=INT_MAX if infeasible
                 cerr<<"\n\n\nATTENTION: THE CONSTRAINT/COL GENERATOR LP BECOME INFEASIBLE. STOP HERE\n \
                        without calling exit because this situation might be normal. Check it. \n\n\n";
                 break;
            }
+           if(!updateCutPool()){
+                cerr<<"\n\n\nATTENTION: THE LP BECOME INFEASIBLE AFTER RE-INJECTING POOLED CUTS. STOP HERE\n";
+                break;
+           }
            //CPLOG("  -> "<<upBound<<endl);
            it ++;
            tm = getCPUTime() - startTm;
-           CPLOG("ITER="<<it<<" TIME="<<tm<<" LBND="<<currObj<<"        //message from Cutting Planes engine"<<endl);
+           if((statsCallback!=NULL)||(statsOut!=NULL)){
+               stats.it           = it;
+               stats.cpuTm        = tm;
+               stats.wallTm       = getWallTime() - startWallTm;
+               stats.solveCpuTm   = tmOnlySolve - stats.solveCpuTm;
+               stats.solveWallTm  = getWallTime() - stats.solveWallTm;
+               stats.totalNrCoefs = totalNrCoefs;
+               stats.lpRows       = noRows - cutPoolSize;
+               stats.objVal       = currObj;
+               stats.lowerBound   = ctx.lowerBound;
+               stats.upperBound   = ctx.upperBound;
+               stats.simplexIters = nrSimplexIters - itStartSimplexIters;
+               emitIterStats(stats);
+           }
+           CPLOG("ITER="<<it<<" TIME="<<tm<<" LBND="<<currObj<<" PIVOTS="
+                 <<nrSimplexIters-itStartSimplexIters<<"        //message from Cutting Planes engine"<<endl);
+           itStartSimplexIters = nrSimplexIters;
        }while((tm<=tmMax)&& it<=itMax);
        it++;
-       freeData(newCut,newRightHandMore,newCutMore,maxMoreConstr);
+       freeAllCutData();
        return EXIT_FAILURE;                                 //not success
   }
-  catch (IloCplex::Exception e){
-       d.cplex.exportModel("trycatch.lp");
-       cerr<<"\n\nConcert Exception Cutting-Planes:"<<e.getMessage()<<endl;
+  catch (lpBackendError e){
+       d.lp.exportModel("trycatch.lp");
+       cerr<<"\n\nLP solver error in Cutting-Planes:"<<e.getMessage()<<endl;
        cerr<<"Model saved to trycatch.lp. I. I think the problem is infeasible. \n";
        cerr<<"I do not call exit, because this infeasibility/error might be normal.  You should check this.\n"; 
        return EXIT_FAILURE;
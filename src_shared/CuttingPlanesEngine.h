@@ -1,8 +1,10 @@
 /*----------------------------------------------------------------------------------------------+
 |               Cutting Planes Engine to solve an LP adding constraints one by one              |
-|                   - using the cheshire cat technique, no need to include cplex                | 
+|                   - using the cheshire cat technique, no need to include solver               | 
 |                     .h headers in all files that include CuttingPlanesEngine.h,               |
 |                     significantly speeding-up compilation                                     |    
+|                   - the LP solver (cplex or glpk) is hidden in lpBackend.h, the Makefiles     |
+|                     select its implementation at build time with LPSOLVER=cplex or glpk       |
 ---------+-------------------------------------------------------------------------+------------+
          | See file LICENSE at the root of the git project for licence information |
          +------------------------------------------------------------------------*/
@@ -22,9 +24,9 @@
                                 //to other stream via printProgressMsg(...)
 //#define CPLOG(x) cplog<<__LINE__<<x
 
-#define NO_CPLEX_OUTPUT         //disable terminal output for cplex routines
+#define NO_CPLEX_OUTPUT         //disable terminal output for the LP solver routines
 
-#define THREADS 1               //The number of threads to use in cplex solver. Let 0 the
+#define THREADS 1               //The number of threads to use in the LP solver (cplex). Let 0 the
                                 //default and it will choose the nr of CPUs or hyper-threads of the machine
 
 #define EPS 1.0e-6              //A specific epsilon
@@ -41,6 +43,17 @@
                 |typedefs for SEPARATOR FUNCTIONS (see USAGE EXAMPLE below)|
                 +---------------------------------------------------------*/
 
+//The state an engine shares with its cut separator, given to the separator as last
+//argument. Each engine has its own context (there are no process globals), so that
+//several engines can run at the same time in different threads
+typedef struct cutPlanesCtx_{
+    double lowerBound;        //solve() writes lowerBound when minimizing, upperBound when
+    double upperBound;        //maximizing; the separator can write the other one
+    int    switchToIntVarsNow;//put this 1 when the cut separator decides to switch
+    void*  userData;          //the data of the separator, e.g., its instance, see
+                              //setSeparatorData()
+} cutPlanesCtx;
+
 //given current solution primals (dimension nrVars), find a new cut newCut and the
 //associated rightHandVal. Writing a=newCut et b=rightHandVal, the added cut is:
 //  maximize=1   =>              a^T x <= b   => Return value  b - a^T x
@@ -49,21 +62,60 @@
 //If the cut separator realizes the gap is closed, it returns INT_MAX and cutPlanes stops
 //Attention: one can modify primals, but it is not recommended
 typedef double (*cutSeprtSimple_t) (const int nrVars, double*primals, 
-                                  double * newCut, double&newRightHand);
+                                  double * newCut, double&newRightHand, cutPlanesCtx&ctx);
 //Same as above, but it sends to the separator the current iteration it and time tm 
 typedef double (*cutSeprtSolver_t) (const int nrVars, double*primals, 
                                  double * newCut, double&newRightHand
-                                 ,int it, double tm);
+                                 ,int it, double tm, cutPlanesCtx&ctx);
 //A separator that can return multiple cuts
 typedef double (*cutSeprtExtended_t) (const int nrVars, double*primals, 
                                   double * newCut, double&newRightHand,
                                   int it, double tm,
                                   double **newCutMore, double*newRightHandMore,
-                                  int & newMore, int maxMoreLen);
+                                  int & newMore, int maxMoreLen, cutPlanesCtx&ctx);
+
+//A cut given only by its non-zero coefficients: val[k] is the coefficient of variable
+//idx[k], for k=0..nnz-1. Cutting-stock patterns or robust-LP rows are often very sparse,
+//so the engine can build such a cut in O(nnz) without scanning all nrVars positions
+typedef struct sparseCut_{
+    int     nnz;              //number of non-zeros, i.e., used positions of idx and val
+    int*    idx;              //variable indices, each one of them appearing at most once
+    double* val;              //coefficients
+    double  rHand;            //right-hand side
+    int     sense;            //1 for <=, -1 for >=, or 0 for ==
+} sparseCut;
+//Same as cutSeprtExtended_t, but the separator writes its cuts in sparse form. The arrays
+//idx and val of newCut and of the maxMoreLen cuts newCutMore[...] have nrVars positions
+typedef double (*cutSeprtSparse_t) (const int nrVars, double*primals,
+                                  sparseCut& newCut, int it, double tm,
+                                  sparseCut*newCutMore, int & newMore, int maxMoreLen,
+                                  cutPlanesCtx&ctx);
 
-extern double lowerBound;         //global variable visible in the cut separator
-extern double upperBound;         //global variable visible in the cut separator
-extern int    switchToIntVarsNow ;//put this 1 when the cut separator decides to switch
+/*--------------+----------------------------------------------------------+-------------
+                |     TELEMETRY: statistics of each runCutPlanes iteration  |
+                +---------------------------------------------------------*/
+
+//Recorded at the end of each iteration of runCutPlanes (after the master re-solve).
+//CPU times are those of the process (all threads), wall times are real elapsed times
+typedef struct iterStats_{
+    int    it;                //the iteration, 1 for the first one
+    double cpuTm, wallTm;     //since the start of runCutPlanes
+    double solveCpuTm;        //master re-solve(s) of the iteration, cut pool re-solves included
+    double solveWallTm;
+    double sepCpuTm;          //the cutSeprt call of the iteration, 0 if the round used stale
+    double sepWallTm;         //cuts from the pipelined mode (see activatePipelining)
+    double overlapSepWallTm;  //pipelined mode: the separation run during the re-solve
+    int    nrCutsAdded;
+    long   totalNrCoefs;      //non-zeros of all cuts added so far
+    int    lpRows;            //cuts in the LP, i.e., without the cut pool
+    double objVal;
+    double lowerBound, upperBound;
+    long   simplexIters;      //pivots of the iteration
+} iterStats;
+//userData is the pointer given to setIterStatsCallback, e.g., to aggregate several runs
+typedef void (*iterStatsCallback_t)(const iterStats& st, void* userData);
+#define ITER_STATS_CSV   0    //formats of writeIterStats()
+#define ITER_STATS_JSONL 1    //one JSON object per line
 
 /*-----------------------+------------------------------------+--------------------------
                          |          MAIN CLASS                |
@@ -75,6 +127,7 @@ class CuttingPlanesEngine{
     CuttingPlanesEngine(int nrVars, cutSeprtSimple_t pSimple);
     CuttingPlanesEngine(int nrVars, cutSeprtSolver_t pComplex);
     CuttingPlanesEngine(int nrVars, cutSeprtExtended_t pExtended, int maxMoreConstrToReturn);
+    CuttingPlanesEngine(int nrVars, cutSeprtSparse_t pSparse, int maxMoreConstrToReturn);
     //classical destructor
     ~CuttingPlanesEngine();
 
@@ -103,6 +156,14 @@ class CuttingPlanesEngine{
     void setTimeoutSolve(double timeout);
     //Ask to always turn to integer at the end
     void alwaysTurnIntegerInTheEnd();
+    //the context given to the cutSeprt (bounds, switchToIntVarsNow and its data)
+    cutPlanesCtx& getCtx();
+    //the userData of the context, e.g., the instance solved by the cutSeprt
+    void setSeparatorData(void* userData);
+    //the bounds of the context: the master objective gives one of them (the upper bound
+    //when maximizing), the cutSeprt can give the other one
+    double getLowerBound();
+    double getUpperBound();
     //Gets the objective value (it does not verify that the model is fully optimized)
     double getObjVal();
     //Add to the model a new cut 
@@ -114,15 +175,58 @@ class CuttingPlanesEngine{
     int modelAddWithSense(double * coefs, double rightHand, int sense);
     //Add to the model an equality, return id of the new constraint
     int modelAddEquality(int * coefs, double rightHand);
+    //Add to the model a sparse cut, its sense is given by cut.sense
+    //Return value: the number (id) of the new constraint
+    int modelAddCut(const sparseCut& cut);
+    //Add nr cuts to the model in a single batch (one model update instead of nr ones)
+    //Return value: the id of the first new constraint, the others follow consecutively
+    int modelAddCuts(const sparseCut* cuts, int nr);
+    int modelAddCuts(double ** coefs, double* rightHands, int nr); //all cuts coefs[i]^T x <= rightHands[i]
+
+    //Enable the cut pool: a cut added by runCutPlanes is moved out of the LP (to an off-LP
+    //pool) when its dual stays zero for more than maxAge consecutive rounds. A pooled cut
+    //keeps its id and it is re-injected as soon as the primals violate it. 0 disables it (default)
+    void activateCutPool(int maxAge);
+    //the number of cuts currently in the off-LP pool, the LP has getNbCuts()-getCutPoolSize() rows
+    int  getCutPoolSize();
+    //the total number of purges (moves to the pool) and re-activations (moves back to the LP)
+    long getNrPurgedCuts();
+    long getNrReactivatedCuts();
 
     //deletes constraint of nr/id i
     void modelDelCut(int i);
-    //the coefficient (dual value) of the constraint of nr/id i
+    //the coefficient (dual value) of the constraint of nr/id i (0 if it is in the cut pool)
     double getCutDualVal(int i);
     //the righthand of cut nr/id i
     double getCutRightHand(int i);
     //returns the CPU time needed only to re-optimize after each cut (excluding the separation time)
     double getTmOnlySolve();
+    //returns the CPU time spent inserting the separated cuts into the model
+    double getTmInsertCuts();
+    //Incremental re-optimization: each re-solve runs the dual simplex from the basis saved
+    //after the previous solve (this basis remains dual feasible after adding cuts). The
+    //basis is also restored if a randomized solve (setObjCoefs...RandomizedSolving) fails
+    void activateWarmStart();
+    //the total number of simplex iterations (pivots) of all solves, resp. of the last solve()
+    long getNrSimplexIters();
+    long getLastNrSimplexIters();
+    //Pipelined mode of runCutPlanes: while the master re-solves, a worker thread calls the
+    //cutSeprt again on the previous primals. Its cuts still violated by the new primals are
+    //inserted at the next round, which then skips the cutSeprt call; the next re-solve
+    //overlaps with the separation of these new primals. It pays off when a second call
+    //on the same primals gives new cuts, e.g., when the cutSeprt keeps an interior point.
+    //The cutSeprt must not call the engine and it runs in a different thread than solve().
+    //It sees the ctx bounds as before the parallel re-solve. The CPU times include
+    //both threads. The master has no pipelining once it has integer variables
+    void activatePipelining();
+    //the number of cuts separated on stale primals and inserted by the pipelined mode
+    long getNrStaleCuts();
+    //Telemetry: cb(st,userData) is called with the statistics st of each iteration of
+    //runCutPlanes, see iterStats. Use NULL to disable it
+    void setIterStatsCallback(iterStatsCallback_t cb, void* userData);
+    //Telemetry: write the iterStats of each iteration to out, as CSV lines (with a header
+    //line written now) or as JSON lines. out must stay open during runCutPlanes
+    void writeIterStats(std::ostream& out, int format);
     //returns the number of recorded cuts
     int getNbCuts();
     //returns the number of integer variables
@@ -138,7 +242,7 @@ class CuttingPlanesEngine{
     //given newCutCoefs (coefficients of a new cut) and right hand, check feasibility
     int    violatedCut(int * newCutCoefs, double rightHand);
     //solve over current columns and return the value of the objective function (restricted model)
-    //set lowerBound = INT_MAX or upperBound = INT_MIN if error and return INT_MAX/INT_MIN if error
+    //set ctx.lowerBound = INT_MAX or ctx.upperBound = INT_MIN and return INT_MAX/INT_MIN if error
     //(not enough time as set by //setTimeoutSolve())
     double solve();
     //puts the dual variables in *yStar (if non null)
@@ -149,6 +253,9 @@ class CuttingPlanesEngine{
     void exportModel(char* filename);
     //releases/free all array memory 
     void freeData(double*&a,double*&b, double**&c,int nr);
+    //allocates (resp. releases) nr sparse cuts with room for n non-zeros each
+    sparseCut* newSparseCuts(int nr);
+    void freeSparseCuts(sparseCut*&cuts, int nr);
 
     //Solve column generator using a cutSeprt routine called 'cutSeprt' 
     //Params itMax and tmMax indicate the maximum allowed time and iterations
@@ -171,25 +278,56 @@ class CuttingPlanesEngine{
     double * primals;
     double currObj;                 //the optimum of the restricted program 
     int * intStatus;                //indicate which variables are integer
-    class cplexCheshireData & d;    //d-reference (see d-pointer, compiler firewall or cheshire data)
-                                    //need no cplex include outside cplex.cpp, faster compilation
+    class engineCheshireData & d;   //d-reference (see d-pointer, compiler firewall or cheshire data)
+                                    //need no solver include outside lpBackend*.cpp, faster compilation
                                     //At the file bottom,you find the stack-overflow post used to it
     long totalNrCoefs;              //The total number of non-zero coefficients added by the cuts
     int maximize ;
     int primalsSetByUser ;          //If you call setPrimals, this will be set
+    cutPlanesCtx ctx;               //see getCtx()
     void init();
     cutSeprtSimple_t internalCutSeprtSimple;
     cutSeprtSolver_t internalCutSeprtSolver;
     cutSeprtExtended_t internalCutSeprtExtended;
+    cutSeprtSparse_t internalCutSeprtSparse;
     int maxMoreConstr;
     int turnIntegerEnd;
     double timeoutSet;
     double tmOnlySolve;
+    double tmInsertCuts;            //total time of all batch insertions
+    int  warmStart;                 //see activateWarmStart()
+    long nrSimplexIters;
+    long lastNrSimplexIters;        //of the last solve(), randomized re-solves included
+    int  pipelined;                 //see activatePipelining()
+    long nrStaleCuts;
+    iterStatsCallback_t statsCallback;
+    void* statsUserData;
+    std::ostream* statsOut;         //see writeIterStats, NULL if disabled
+    int  statsFormat;
+    int  deferBounds;               //if 1, solve() puts the new bound in pendingBound
+    int  boundPending;
+    double pendingBound;
+    double lastTmInsertCuts;        //time of the last batch insertion
+    int  cutPoolMaxAge;             //see activateCutPool(), 0 means no pool management
+    int  cutPoolSize;               //number of cuts out of the LP
+    long nrPurgedCuts;
+    long nrReactivatedCuts;
 #ifdef TIMEOUT_BEFORE_GOING_SUBOPTIMAL_PRIMALS
     int suboptimal;
 #endif
     //Internals:
     double runSelectedCutSeprt(const int nrVars, double*yyy, double * newRow,double&newRightHand, int it, double tm, double ** newCutMore,double*newRightHandMore, int&newMore, int maxMoreConstr);
+    double runSelectedCutSeprt(const int nrVars, double*yyy, sparseCut&newCut, int it, double tm, sparseCut*newCutMore, int&newMore, int maxMoreConstr);
+    //insert the main cut and the nrMore additional cuts of a round in one batch
+    //use purgeable=1 to let the cut pool purge these cuts (see activateCutPool)
+    int modelAddCutRound(const sparseCut& cut, const sparseCut*cutsMore, int nrMore, int purgeable);
+    int modelAddCutRound(double*coefs, double rightHand, double**coefsMore, double*rightHandsMore, int nrMore, int purgeable);
+    //send st to the telemetry callback and/or stream
+    void emitIterStats(const iterStats& st);
+    //cut pool internals
+    void markPurgeable(int firstId, int nr);
+    int  reinjectViolatedPoolCuts();
+    int  updateCutPool();
     //an internal to set a param
     void setToleranceParamToEpsilon();
 };
@@ -212,7 +350,8 @@ using namespace std;
 //                               a^T x >= b
 //Return value: a^T x - b, i.e., a negative value if x violates newCut, positive otherwise
 //This cut example implements the cut family a^T x >=1, for all a with 2 non-zero values
-double separator (const int nrVars, double*x, double * newCut, double&rightHandVal)
+double separator (const int nrVars, double*x, double * newCut, double&rightHandVal,
+                  cutPlanesCtx&ctx)
 {
     int indexMin = 0;
     //cout<<"Current decision variables x";
@@ -297,7 +436,8 @@ using namespace std;
 //                               a^T x <= b
 //Return value: b- a^T x , i.e., a negative value if x violates newCut, positive otherwise
 //This cut example implements the cut family a^T x >=1, for all a with 2 non-zero values
-double separatorTriplets (const int nrVars, double*x, double * newCut, double&rightHandVal){ 
+double separatorTriplets (const int nrVars, double*x, double * newCut, double&rightHandVal,
+                          cutPlanesCtx&ctx){ 
     int indexMax = 0;
     //cout<<"Current decision variables x";
     //for(int i=0;i<nrVars;i++)
@@ -118,6 +118,40 @@ extern "C"{
   
   	return -1.0;		/* Failed. */
   }
+
+  double getWallTime( )
+  {
+  #if defined(_WIN32)
+  	LARGE_INTEGER freq, count;
+  	if ( QueryPerformanceFrequency( &freq ) && QueryPerformanceCounter( &count ) )
+  		return (double)count.QuadPart / (double)freq.QuadPart;
+  #elif defined(CLOCK_MONOTONIC)
+  	struct timespec ts;
+  	if ( clock_gettime( CLOCK_MONOTONIC, &ts ) == 0 )
+  		return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+  #endif
+  	return -1.0;		/* Failed. */
+  }
+
+  double getThreadCPUTime( )
+  {
+  #if defined(_WIN32)
+  	FILETIME createTime, exitTime, kernelTime, userTime;
+  	if ( GetThreadTimes( GetCurrentThread( ),
+  		&createTime, &exitTime, &kernelTime, &userTime ) != 0 )
+  	{
+  		ULARGE_INTEGER li;
+  		li.LowPart  = userTime.dwLowDateTime;
+  		li.HighPart = userTime.dwHighDateTime;
+  		return (double)li.QuadPart / 10000000.0;
+  	}
+  #elif defined(_POSIX_THREAD_CPUTIME) && defined(CLOCK_THREAD_CPUTIME_ID)
+  	struct timespec ts;
+  	if ( clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts ) == 0 )
+  		return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+  #endif
+  	return getCPUTime( );	/* No per-thread clock, fall back to the process. */
+  }
 }
 
 //int to string, a C++ classical
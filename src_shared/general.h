@@ -35,6 +35,16 @@ extern "C" {
    * in *fractional* seconds, or -1.0 if an error occurred.
    */
   double getCPUTime( );
+  /**
+   * Returns the wall-clock (real) time in *fractional* seconds elapsed since an arbitrary
+   * fixed moment, or -1.0 if an error occurred. Only differences are meaningful.
+   */
+  double getWallTime( );
+  /**
+   * Returns the amount of CPU time used by the calling thread only, in *fractional*
+   * seconds. It falls back to getCPUTime() when the OS has no per-thread clock.
+   */
+  double getThreadCPUTime( );
 }
 
 std::string toString(int number);
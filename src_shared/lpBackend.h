@@ -0,0 +1,106 @@
+/*----------------------------------------------------------------------------------------------+
+|               LP solver backend used by the Cutting Planes Engine                             |
+|                   - one class, two implementations selected at link time:                     |
+|                        lpBackendCplex.cpp  (IBM CPLEX via Concert)                            |
+|                        lpBackendGlpk.cpp   (GNU GLPK, open-source, no licence needed)         |
+|                     use LPSOLVER=cplex or LPSOLVER=glpk in the Makefiles                      |
+|                   - cheshire cat technique as in CuttingPlanesEngine.h: no solver header      |
+|                     is needed to include lpBackend.h                                          |
+---------+-------------------------------------------------------------------------+------------+
+         | See file LICENSE at the root of the git project for licence information |
+         +------------------------------------------------------------------------*/
+
+#ifndef LPBACKEND_H_INCLUDED
+#define LPBACKEND_H_INCLUDED
+#include<ostream>
+
+/*-----------------------+------------------------------------+--------------------------
+                         |    STATUS CODES AND EXCEPTIONS     |
+                         +-----------------------------------*/
+#define LP_OPTIMAL             0   //the last solve() found an optimal solution
+#define LP_TIME_LIMIT          1   //stopped by the time limit, primals are available
+#define LP_INFEASIBLE          2
+#define LP_INFEAS_OR_UNBOUNDED 3
+
+//Thrown by the backend when the underlying solver reports an error, e.g., when asking
+//the primals after a failed solve. It replaces the solver-specific exceptions
+class lpBackendError{
+    public:
+    const char* msg;
+    lpBackendError(const char* m): msg(m){};
+    const char* getMessage(){return msg;};
+};
+
+/*-----------------------+------------------------------------+--------------------------
+                         |          MAIN CLASS                |
+                         +-----------------------------------*/
+//Variables are numbered 0..nrVars-1 and rows by an id 0,1,2... in the order of insertion.
+//A row is a range lhsMin <= coefs^T x <= lhsMax, use +/-lpInfinity() for one-sided rows.
+//A row id never changes, even if other rows are deleted or taken out of the LP
+class lpBackend{
+    public:
+    lpBackend(int nrVars);
+    ~lpBackend();
+    //the name of the solver, e.g., for printing
+    const char* name();
+    double lpInfinity();
+    //Below: parameters
+    void setThreads(int threads);
+    void setFeasibilityTol(double tol);
+    void setIntegralityTol(double tol);
+    void setNumericalEmphasis(int on);
+    void setTimeLimit(double secs);
+    void disableOutput();
+
+    //Below: variables
+    void setVarBounds(int i, double lb, double ub);
+    double getVarLB(int i);
+    void addVar(double objCoef, double lb, double ub);
+    void removeVar(int i);
+    void swapVars(int i, int j);
+    void setVarInteger(int i);
+    //Below: objective function
+    void setObj(double* coefs, int maximize);
+    void setObj(int*    coefs, int maximize);
+    //Below: rows. Return value: the id of the first new row
+    //row k has nnz[k] non-zeros val[k][0..nnz[k]-1] on variables idx[k][0..nnz[k]-1]
+    int  addRows(int nr, const int* nnz, int*const* idx, double*const* val,
+                 const double* lhsMin, const double* lhsMax);
+    //take row id out of the LP, resp. put it back; the row keeps its id and coefficients
+    void removeRowFromLP(int id);
+    void addRowBackToLP(int id);
+    //delete row id for good
+    void delRow(int id);
+    double getRowLB(int id);
+    double getDual(int id);
+
+    //Below: solve. Return value: one of the LP_... status codes above
+    int    solve();
+    //solve with objective tmpCoefs under the constraint that the (current) objective
+    //origCoefs keeps the last optimal value; it can report different optimal solutions
+    int    solveWithObjFixed(double* origCoefs, double* tmpCoefs);
+    double getObjVal();
+    void   getPrimals(double* x);
+    //a starting point for the next solve()
+    void   setStart(double* x);
+    void   exportModel(const char* filename);
+    //the simplex iterations (pivots) of the last solve() or solveWithObjFixed()
+    long   getNrIters();
+
+    //Below: incremental re-optimization. With setWarmStart(1), solve() runs the dual simplex
+    //from the current basis. The slacks of new rows enter basic, so the last optimal basis
+    //stays dual feasible after adding cuts and a re-solve needs only a few pivots
+    void   setWarmStart(int on);
+    //keep (resp. load back) the basis statuses of the variables and of the rows in the LP;
+    //the rows added (or put back) after saveBasis() enter the restored basis with basic slack
+    void   saveBasis();
+    void   restoreBasis();
+    //1 if the slack of row id is basic in the saved basis, or if there is no saved basis.
+    //Taking out of the LP a row with a non-basic slack invalidates the basis
+    int    rowSlackBasic(int id);
+
+    private:
+    int n;
+    class lpCheshireData & d;      //see CuttingPlanesEngine.h for the d-reference
+};
+#endif
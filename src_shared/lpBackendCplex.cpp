@@ -0,0 +1,418 @@
+/*----------------------------------------------------------------------------------------------+
+|               LP solver backend: IBM CPLEX implementation (via Concert Technology)           |
+---------+-------------------------------------------------------------------------+------------+
+         | See file LICENSE at the root of the git project for licence information |
+         +------------------------------------------------------------------------*/
+
+#include "lpBackend.h"
+#include <climits>
+#include <cmath>
+#include <vector>
+#include <ilcplex/ilocplex.h>
+using namespace std;
+
+//The cples parameters change from version to version. The macros below
+//may prevent such problems, based on a CPLEXVER that can be defined by the
+//compilation line using option -D. It should contain 3 digits
+#if !defined CPLEXVER ||  (CPLEXVER>=129)
+    #define TIME_LIMIT_PARAM            IloCplex::Param::TimeLimit
+    #define MAX_THREADS_PARAM           IloCplex::Param::Threads
+    #define NUMERICAL_EMPHASIS_PARAM    IloCplex::Param::Emphasis::Numerical
+    #define FEASIBLE_TOLERANCE_PARAM    IloCplex::Param::Simplex::Tolerances::Feasibility
+    #define ROOT_ALGORITHM_PARAM        IloCplex::Param::RootAlgorithm
+    #define ADVANCED_START_PARAM        IloCplex::Param::Advance
+#else
+    #define TIME_LIMIT_PARAM            IloCplex::TiLim
+    #define MAX_THREADS_PARAM           IloCplex::Threads
+    #define NUMERICAL_EMPHASIS_PARAM    IloCplex::NumericalEmphasis
+    #define FEASIBLE_TOLERANCE_PARAM    IloCplex::EpRHS
+    #define ROOT_ALGORITHM_PARAM        IloCplex::RootAlg
+    #define ADVANCED_START_PARAM        IloCplex::AdvInd
+#endif
+
+class lpCheshireData{                          //From other files, one can refer to this struct
+    public:                                    //without needing to include cplex headers
+    IloEnv         env;
+    IloModel       model;
+    IloNumVarArray vars;
+    IloCplex       cplex ;
+    IloNumArray    lb ;
+    IloNumArray    ub ;
+    IloRangeArray  rows;                       //rows[id] is the row of id id
+    IloObjective   obj;
+    vector<char>   inLP;                       //inLP[id]=0 if row id is out of the model
+    IloRange       objRow;                     //see solveWithObjFixed(), free when unused
+    int            objRowInModel;
+    int            warmStart;
+    long           nrIters;
+    int            basisSaved;                 //the basis below is valid only if this is 1
+    vector<int>    savedVarStat;               //IloCplex::BasisStatus of each variable
+    vector<int>    savedRowStat;               //by row id, -1 for rows out of the model
+    int            savedObjRowStat;
+    lpCheshireData(int n):
+            env(), model(env), vars(env,n,INT_MIN,INT_MAX), cplex (env),
+            lb(env,n), ub (env,n), rows(env), objRowInModel(0), warmStart(0),
+            nrIters(0), basisSaved(0), savedObjRowStat(IloCplex::Basic){
+        cplex.extract(model);
+    };
+};
+
+lpBackend::lpBackend(int nrVars): n(nrVars), d(*new lpCheshireData(nrVars))
+{
+}
+lpBackend::~lpBackend()
+{
+    d.lb.end();
+    d.ub.end();
+    for(int i=d.rows.getSize()-1;i>=0;i--)
+        d.rows[i].end();
+    d.rows.end();
+    if(d.objRowInModel)
+        d.objRow.end();
+    d.vars.end();
+    d.cplex.end();
+    d.model.end();
+    d.env.end();
+    delete &d;
+}
+const char* lpBackend::name()
+{
+    return "cplex";
+}
+double lpBackend::lpInfinity()
+{
+    return IloInfinity;
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |            PARAMETERS              |
+                         +-----------------------------------*/
+void lpBackend::setThreads(int threads)
+{
+    d.cplex.setParam(MAX_THREADS_PARAM,threads);
+}
+void lpBackend::setFeasibilityTol(double tol)
+{
+    //feasibility tolerance: Specifies the feasibility tolerance, the degree
+    //to which the basic variables of a model may violate their bounds.
+    d.cplex.setParam(FEASIBLE_TOLERANCE_PARAM, tol);
+}
+void lpBackend::setIntegralityTol(double tol)
+{
+     //the first below si an old version (<Cplex 2.6) of second below
+     #ifndef CPLEXVER
+        d.cplex.setParam(IloCplex::EpInt, tol);
+     #else
+        //CPLEXVER passed in command line via -D. It should contain 3 digits
+        //see the beginning of the file
+        #if (CPLEXVER>=126)
+            d.cplex.setParam(IloCplex::Param::MIP::Tolerances::Integrality,tol);//you said cplex >=12.6
+        #endif
+     #endif
+}
+void lpBackend::setNumericalEmphasis(int on)
+{
+    d.cplex.setParam(NUMERICAL_EMPHASIS_PARAM, (bool)on);
+}
+void lpBackend::setTimeLimit(double secs)
+{
+    //before enforcing time limits, you may need call below to be sure cplex
+    //thinks in terms of CPU time and not Wall Time which includes dead moments
+    //d.cplex.setParam(IloCplex::Param::ClockType,1);
+    d.cplex.setParam(TIME_LIMIT_PARAM,secs);
+}
+void lpBackend::disableOutput()
+{
+    d.cplex.setOut(d.env.getNullStream());
+    d.cplex.setError(d.env.getNullStream());
+    //This says when it is MIP
+    d.cplex.setWarning(d.env.getNullStream());
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |       VARIABLES AND OBJECTIVE      |
+                         +-----------------------------------*/
+void lpBackend::setVarBounds(int i, double lbnd, double ubnd)
+{
+    d.lb[i] = lbnd;
+    d.ub[i] = ubnd;
+    d.vars[i].setBounds(lbnd, ubnd);
+}
+double lpBackend::getVarLB(int i)
+{
+    return d.lb[i];
+}
+void lpBackend::addVar(double objCoef, double min, double max)
+{
+    d.vars.add(IloNumVar(d.obj(objCoef), min, max));
+    d.lb.add(min);
+    d.ub.add(max);
+    n++;
+}
+void lpBackend::removeVar(int i)
+{
+    d.vars[i].end();
+    d.vars.remove(i);
+    d.lb.remove(i);
+    d.ub.remove(i);
+    n--;
+}
+void lpBackend::swapVars(int i, int j)
+{
+    IloNumVar tmp = d.vars[i];
+    d.vars[i]     = d.vars[j];
+    d.vars[j]     = tmp;
+    double  tmpd  = d.lb[i];
+    d.lb[i]       = d.lb[j];
+    d.lb[j]       = tmpd;
+    tmpd          = d.ub[i];
+    d.ub[i]       = d.ub[j];
+    d.ub[j]       = tmpd;
+}
+void lpBackend::setVarInteger(int i)
+{
+    d.model.add(IloConversion(d.env, d.vars[i], ILOINT));
+}
+#define setObjCoefs(coefs,maximize)                                                   \
+  do{                                                                                 \
+    IloExpr expr(d.env);                                                              \
+    for(int i=0;i<n;i++)                                                              \
+        if(abs(coefs[i])>1.0e-6)                                                      \
+            expr+=coefs[i]* d.vars[i];                                                \
+    d.obj = IloObjective(d.env, expr, maximize?IloObjective::Maximize:                \
+                                               IloObjective::Minimize);               \
+    d.model.add(d.obj);                                                               \
+    expr.end();                                                                       \
+  }while(false);
+void lpBackend::setObj(double* coefs, int maximize)
+{
+    setObjCoefs(coefs,maximize);
+}
+void lpBackend::setObj(int* coefs, int maximize)
+{
+    setObjCoefs(coefs,maximize);
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |               ROWS                 |
+                         +-----------------------------------*/
+//All new rows reach the model in a single add, so that cplex synchronizes (extracts)
+//them once per call and not once per row
+int lpBackend::addRows(int nr, const int* nnz, int*const* idx, double*const* val,
+                       const double* lhsMin, const double* lhsMax)
+{
+    int firstId = d.rows.getSize();
+    IloRangeArray batch(d.env);
+    for(int k=0;k<nr;k++){
+        IloNumVarArray rowVars(d.env);
+        IloNumArray    rowCoefs(d.env);
+        for(int j=0;j<nnz[k];j++){
+            rowVars.add(d.vars[idx[k][j]]);
+            rowCoefs.add(val[k][j]);
+        }
+        IloRange range(d.env, lhsMin[k], lhsMax[k]);
+        range.setLinearCoefs(rowVars, rowCoefs);
+        batch.add(range);
+        rowVars.end();
+        rowCoefs.end();
+    }
+    d.rows.add(batch);
+    d.model.add(batch);
+    batch.end();
+    d.inLP.resize(firstId+nr, 1);
+    return firstId;
+}
+void lpBackend::removeRowFromLP(int id)
+{
+    d.model.remove(d.rows[id]);
+    d.inLP[id] = 0;
+}
+void lpBackend::addRowBackToLP(int id)
+{
+    d.model.add(d.rows[id]);
+    d.inLP[id] = 1;
+}
+void lpBackend::delRow(int id)
+{
+    d.rows[id].end();
+    d.inLP[id] = 0;
+}
+double lpBackend::getRowLB(int id)
+{
+    return d.rows[id].getLB();
+}
+double lpBackend::getDual(int id)
+{
+    return d.cplex.getDual(d.rows[id]);
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |               SOLVE                |
+                         +-----------------------------------*/
+int lpBackend::solve()
+{
+    try{
+        d.nrIters = 0;
+        d.cplex.solve();
+        d.nrIters = d.cplex.getNiterations();
+        if(d.cplex.getCplexStatus()==IloCplex::AbortTimeLim)
+            return LP_TIME_LIMIT;
+        d.cplex.getObjValue();                 //throws if there is no solution
+    }catch (IloCplex::Exception e){
+        if(d.cplex.getStatus()==IloAlgorithm::InfeasibleOrUnbounded)
+            return LP_INFEAS_OR_UNBOUNDED;
+        if(d.cplex.getStatus()!=IloAlgorithm::Infeasible)
+            throw lpBackendError("Concert exception in cplex.solve()");
+    }
+    if(d.cplex.getStatus()==IloAlgorithm::Infeasible)
+        return LP_INFEASIBLE;
+    return LP_OPTIMAL;
+}
+//The row fixing the objective stays in the model (free) between calls: removing it would
+//discard the advanced basis whenever its slack is non-basic
+int lpBackend::solveWithObjFixed(double* origCoefs, double* tmpCoefs)
+{
+    if(!d.objRowInModel){
+        d.objRow = IloRange(d.env, -IloInfinity, IloInfinity);
+        d.model.add(d.objRow);
+        d.objRowInModel = 1;
+    }
+    for(int i=0;i<n;i++)
+         d.objRow.setLinearCoef(d.vars[i],origCoefs[i]);
+    double optVal = d.cplex.getObjValue();
+    d.objRow.setBounds(optVal, optVal);
+    for(int i=0;i<n;i++)
+         d.obj.setLinearCoef(d.vars[i],tmpCoefs[i]);
+    //the basis stays primal feasible in both solves below, the primal simplex fits better
+    if(d.warmStart)
+        d.cplex.setParam(ROOT_ALGORITHM_PARAM, IloCplex::Primal);
+    d.cplex.solve();
+    long itersFixed = d.cplex.getNiterations();
+    d.objRow.setBounds(-IloInfinity, IloInfinity);
+    for(int i=0;i<n;i++)
+         d.obj.setLinearCoef(d.vars[i],origCoefs[i]);
+    int status = solve();
+    if(d.warmStart)
+        d.cplex.setParam(ROOT_ALGORITHM_PARAM, IloCplex::Dual);
+    d.nrIters += itersFixed;
+    return status;
+}
+double lpBackend::getObjVal()
+{
+    return d.cplex.getObjValue();
+}
+void lpBackend::getPrimals(double* x)
+{
+    IloNumArray solution(d.env);
+    try{
+        d.cplex.getValues (d.vars,solution);
+    }catch (IloCplex::Exception e){
+        solution.end();
+        throw lpBackendError("Concert exception in cplex.getValues()");
+    }
+    for(int i=0;i<n;i++)
+        x[i] = solution[i];
+    solution.end();
+}
+void lpBackend::setStart(double* x)
+{
+     IloNumArray startValues(d.env);
+     for (int i = 0; i < n; ++i)
+             startValues.add(x[i]);
+     try{
+        //d.cplex.addMIPStart(d.vars, startValues);
+        d.cplex.setStart(startValues,NULL,d.vars,NULL,NULL,NULL);
+     }catch (IloCplex::Exception e){
+        startValues.end();
+        throw lpBackendError("Concert exception when setting initial values for variables");
+     }
+     startValues.end();
+}
+void lpBackend::exportModel(const char* filename)
+{
+    d.cplex.exportModel(filename);
+}
+long lpBackend::getNrIters()
+{
+    return d.nrIters;
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |     WARM START AND BASIS REUSE     |
+                         +-----------------------------------*/
+void lpBackend::setWarmStart(int on)
+{
+    d.warmStart = on;
+    d.cplex.setParam(ADVANCED_START_PARAM, 1);
+    d.cplex.setParam(ROOT_ALGORITHM_PARAM, on ? IloCplex::Dual : IloCplex::AutoAlg);
+}
+//the rows in the model, with their ids in ids
+static void rowsInModel(lpCheshireData& d, IloRangeArray& lpRows, vector<int>& ids)
+{
+    for(int id=0;id<(int)d.inLP.size();id++)
+        if(d.inLP[id]){
+            lpRows.add(d.rows[id]);
+            ids.push_back(id);
+        }
+    if(d.objRowInModel)
+        lpRows.add(d.objRow);
+}
+void lpBackend::saveBasis()
+{
+    IloRangeArray lpRows(d.env);
+    vector<int>   ids;
+    rowsInModel(d, lpRows, ids);
+    IloCplex::BasisStatusArray varStat(d.env), rowStat(d.env);
+    d.basisSaved = 0;
+    try{
+        d.cplex.getBasisStatuses(varStat, d.vars, rowStat, lpRows);
+        d.savedVarStat.resize(n);
+        for(int i=0;i<n;i++)
+            d.savedVarStat[i] = varStat[i];
+        d.savedRowStat.assign(d.rows.getSize(), -1);
+        for(int k=0;k<(int)ids.size();k++)
+            d.savedRowStat[ids[k]] = rowStat[k];
+        if(d.objRowInModel)
+            d.savedObjRowStat = rowStat[(int)ids.size()];
+        d.basisSaved = 1;
+    }catch (IloCplex::Exception e){
+        //no basis available (e.g., after a MIP solve): the next restoreBasis does nothing
+    }
+    varStat.end();
+    rowStat.end();
+    lpRows.end();
+}
+void lpBackend::restoreBasis()
+{
+    if((!d.basisSaved)||((int)d.savedVarStat.size()!=n))
+        return;                                //no basis or variables added/removed since
+    IloRangeArray lpRows(d.env);
+    vector<int>   ids;
+    rowsInModel(d, lpRows, ids);
+    IloCplex::BasisStatusArray varStat(d.env), rowStat(d.env);
+    for(int i=0;i<n;i++)
+        varStat.add((IloCplex::BasisStatus)d.savedVarStat[i]);
+    for(int k=0;k<(int)ids.size();k++){
+        int id = ids[k];
+        if((id<(int)d.savedRowStat.size())&&(d.savedRowStat[id]>=0))
+            rowStat.add((IloCplex::BasisStatus)d.savedRowStat[id]);
+        else
+            rowStat.add(IloCplex::Basic);      //a new row enters with its slack basic
+    }
+    if(d.objRowInModel)
+        rowStat.add((IloCplex::BasisStatus)d.savedObjRowStat);
+    try{
+        d.cplex.setBasisStatuses(varStat, d.vars, rowStat, lpRows);
+    }catch (IloCplex::Exception e){
+        //not fatal, the next solve only loses the warm start
+    }
+    varStat.end();
+    rowStat.end();
+    lpRows.end();
+}
+int lpBackend::rowSlackBasic(int id)
+{
+    if((!d.basisSaved)||(id>=(int)d.savedRowStat.size())||(d.savedRowStat[id]<0))
+        return 1;
+    return (d.savedRowStat[id]==IloCplex::Basic);
+}
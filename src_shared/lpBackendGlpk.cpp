@@ -0,0 +1,423 @@
+/*----------------------------------------------------------------------------------------------+
+|               LP solver backend: GNU GLPK implementation (open-source, no licence needed)    |
+|                   - the rows are stored from glpk row 1 on, but a row id is never changed:    |
+|                     glpkRow[id] gives the current glpk row of id (0 if out of the LP)        |
+|                   - glpk arrays are 1-based: position 0 of ind[] and val[] is not used       |
+---------+-------------------------------------------------------------------------+------------+
+         | See file LICENSE at the root of the git project for licence information |
+         +------------------------------------------------------------------------*/
+
+#include "lpBackend.h"
+#include <climits>
+#include <cmath>
+#include <vector>
+#include <glpk.h>
+using namespace std;
+
+#define GLPK_INFINITY 1.0e30           //any bound beyond this value is considered infinite
+
+//The coefficients of a row taken out of the LP, kept to put it back later
+class glpkOutRow{
+    public:
+    vector<int>    ind;                        //1-based, as glpk
+    vector<double> val;
+    double lhsMin, lhsMax;
+};
+class lpCheshireData{                          //From other files, one can refer to this struct
+    public:                                    //without needing to include glpk.h
+    glp_prob*  lp;
+    glp_smcp   smParams;                       //simplex parameters
+    glp_iocp   ioParams;                       //branch-and-cut parameters
+    vector<int> glpkRow;                       //glpkRow[id] = glpk row of id, 0 if out of LP
+    vector<int> rowOfGlpk;                     //inverse of glpkRow, rowOfGlpk[0] not used
+                                               //and -1 for objRow
+    vector<glpkOutRow> outRows;                //outRows[id] is used only if id is out of LP
+    vector<double> lb;
+    int nrIntVars;
+    int objRow;                                //see solveWithObjFixed(), 0 if not yet added
+    int warmStart;
+    long nrIters;
+    int basisSaved;                            //the basis below is valid only if this is 1
+    vector<int> savedColStat;                  //GLP_BS, GLP_NL,... of each column
+    vector<int> savedRowStat;                  //by row id, 0 for rows out of the LP
+    int savedObjRowStat;
+    lpCheshireData(int n): lp(glp_create_prob()), rowOfGlpk(1,-1), lb(n,-GLPK_INFINITY),
+                           nrIntVars(0), objRow(0), warmStart(0), nrIters(0),
+                           basisSaved(0), savedObjRowStat(GLP_BS){
+        glp_init_smcp(&smParams);
+        glp_init_iocp(&ioParams);
+        smParams.presolve = GLP_OFF;           //keep the basis from one solve to the next
+        ioParams.presolve = GLP_ON;
+        if(n>0){
+            glp_add_cols(lp, n);
+            for(int j=1;j<=n;j++)
+                glp_set_col_bnds(lp, j, GLP_FR, 0, 0);
+        }
+    };
+};
+
+//the glpk type of bound for lhsMin <= . <= lhsMax
+static int glpkBndType(double lhsMin, double lhsMax)
+{
+    int noMin = (lhsMin<=-GLPK_INFINITY);
+    int noMax = (lhsMax>= GLPK_INFINITY);
+    if(noMin&&noMax)
+        return GLP_FR;
+    if(noMin)
+        return GLP_UP;
+    if(noMax)
+        return GLP_LO;
+    if(lhsMin==lhsMax)
+        return GLP_FX;
+    return GLP_DB;
+}
+
+lpBackend::lpBackend(int nrVars): n(nrVars), d(*new lpCheshireData(nrVars))
+{
+}
+lpBackend::~lpBackend()
+{
+    glp_delete_prob(d.lp);
+    delete &d;
+}
+const char* lpBackend::name()
+{
+    return "glpk";
+}
+double lpBackend::lpInfinity()
+{
+    return GLPK_INFINITY;
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |            PARAMETERS              |
+                         +-----------------------------------*/
+void lpBackend::setThreads(int )
+{
+    //glpk is single-threaded
+}
+void lpBackend::setFeasibilityTol(double tol)
+{
+    d.smParams.tol_bnd = tol;
+}
+void lpBackend::setIntegralityTol(double tol)
+{
+    d.ioParams.tol_int = tol;
+}
+void lpBackend::setNumericalEmphasis(int on)
+{
+    //the closest glpk option: the textbook ratio test is less greedy but more stable
+    d.smParams.r_test = on ? GLP_RT_STD : GLP_RT_HAR;
+}
+void lpBackend::setTimeLimit(double secs)
+{
+    double ms = secs*1000.0;
+    d.smParams.tm_lim = (ms>=INT_MAX) ? INT_MAX : (int)ms;
+    d.ioParams.tm_lim = d.smParams.tm_lim;
+}
+void lpBackend::disableOutput()
+{
+    d.smParams.msg_lev = GLP_MSG_OFF;
+    d.ioParams.msg_lev = GLP_MSG_OFF;
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |       VARIABLES AND OBJECTIVE      |
+                         +-----------------------------------*/
+void lpBackend::setVarBounds(int i, double lbnd, double ubnd)
+{
+    d.lb[i] = lbnd;
+    glp_set_col_bnds(d.lp, i+1, glpkBndType(lbnd,ubnd), lbnd, ubnd);
+}
+double lpBackend::getVarLB(int i)
+{
+    return d.lb[i];
+}
+void lpBackend::addVar(double objCoef, double min, double max)
+{
+    int j = glp_add_cols(d.lp, 1);
+    glp_set_col_bnds(d.lp, j, glpkBndType(min,max), min, max);
+    glp_set_obj_coef(d.lp, j, objCoef);
+    d.lb.push_back(min);
+    n++;
+}
+void lpBackend::removeVar(int i)
+{
+    int num[2] = {0, i+1};
+    glp_del_cols(d.lp, 1, num);
+    d.lb.erase(d.lb.begin()+i);
+    n--;
+}
+//glpk can not permute columns, so the data (bounds, kind, objective, non-zeros) is swapped
+void lpBackend::swapVars(int i, int j)
+{
+    int    nrRows = glp_get_num_rows(d.lp);
+    vector<int>    indI(nrRows+1), indJ(nrRows+1);
+    vector<double> valI(nrRows+1), valJ(nrRows+1);
+    int    lenI   = glp_get_mat_col(d.lp, i+1, indI.data(), valI.data());
+    int    lenJ   = glp_get_mat_col(d.lp, j+1, indJ.data(), valJ.data());
+    glp_set_mat_col(d.lp, i+1, lenJ, indJ.data(), valJ.data());
+    glp_set_mat_col(d.lp, j+1, lenI, indI.data(), valI.data());
+    int    typeI  = glp_get_col_type(d.lp, i+1);
+    double lbI    = glp_get_col_lb(d.lp, i+1),    ubI = glp_get_col_ub(d.lp, i+1);
+    double objI   = glp_get_obj_coef(d.lp, i+1);
+    int    kindI  = glp_get_col_kind(d.lp, i+1);
+    glp_set_col_bnds(d.lp, i+1, glp_get_col_type(d.lp, j+1), glp_get_col_lb(d.lp, j+1),
+                     glp_get_col_ub(d.lp, j+1));
+    glp_set_obj_coef(d.lp, i+1, glp_get_obj_coef(d.lp, j+1));
+    glp_set_col_kind(d.lp, i+1, glp_get_col_kind(d.lp, j+1));
+    glp_set_col_bnds(d.lp, j+1, typeI, lbI, ubI);
+    glp_set_obj_coef(d.lp, j+1, objI);
+    glp_set_col_kind(d.lp, j+1, kindI);
+    double tmpd   = d.lb[i];
+    d.lb[i]       = d.lb[j];
+    d.lb[j]       = tmpd;
+}
+void lpBackend::setVarInteger(int i)
+{
+    if(glp_get_col_kind(d.lp, i+1)==GLP_CV)
+        d.nrIntVars++;
+    glp_set_col_kind(d.lp, i+1, GLP_IV);
+}
+#define setObjCoefs(coefs,maximize)                                                   \
+  do{                                                                                 \
+    glp_set_obj_dir(d.lp, maximize?GLP_MAX:GLP_MIN);                                  \
+    for(int i=0;i<n;i++)                                                              \
+        glp_set_obj_coef(d.lp, i+1, (abs(coefs[i])>1.0e-6)?coefs[i]:0);               \
+  }while(false);
+void lpBackend::setObj(double* coefs, int maximize)
+{
+    setObjCoefs(coefs,maximize);
+}
+void lpBackend::setObj(int* coefs, int maximize)
+{
+    setObjCoefs(coefs,maximize);
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |               ROWS                 |
+                         +-----------------------------------*/
+int lpBackend::addRows(int nr, const int* nnz, int*const* idx, double*const* val,
+                       const double* lhsMin, const double* lhsMax)
+{
+    int firstId = d.glpkRow.size();
+    if(nr<=0)
+        return firstId;
+    int firstRow = glp_add_rows(d.lp, nr);     //all rows added at once
+    vector<int>    ind(n+1);
+    vector<double> vals(n+1);
+    for(int k=0;k<nr;k++){
+        for(int j=0;j<nnz[k];j++){
+            ind[j+1]  = idx[k][j]+1;
+            vals[j+1] = val[k][j];
+        }
+        glp_set_mat_row(d.lp, firstRow+k, nnz[k], ind.data(), vals.data());
+        glp_set_row_bnds(d.lp, firstRow+k, glpkBndType(lhsMin[k],lhsMax[k]), lhsMin[k],
+                         lhsMax[k]);
+        d.glpkRow.push_back(firstRow+k);
+        d.rowOfGlpk.push_back(firstId+k);
+    }
+    d.outRows.resize(d.glpkRow.size());
+    return firstId;
+}
+//glpk renumbers all the rows after the deleted one
+static void delGlpkRow(lpCheshireData& d, int id)
+{
+    int row    = d.glpkRow[id];
+    int num[2] = {0, row};
+    glp_del_rows(d.lp, 1, num);
+    d.rowOfGlpk.erase(d.rowOfGlpk.begin()+row);
+    for(int r=row;r<(int)d.rowOfGlpk.size();r++)
+        if(d.rowOfGlpk[r]>=0)
+            d.glpkRow[d.rowOfGlpk[r]] = r;
+        else
+            d.objRow = r;
+    d.glpkRow[id] = 0;
+}
+void lpBackend::removeRowFromLP(int id)
+{
+    int row = d.glpkRow[id];
+    if(row==0)
+        return;
+    glpkOutRow& out = d.outRows[id];
+    out.ind.resize(n+1);
+    out.val.resize(n+1);
+    int len = glp_get_mat_row(d.lp, row, out.ind.data(), out.val.data());
+    out.ind.resize(len+1);
+    out.val.resize(len+1);
+    out.lhsMin = glp_get_row_lb(d.lp, row);
+    out.lhsMax = glp_get_row_ub(d.lp, row);
+    int type   = glp_get_row_type(d.lp, row);
+    if((type==GLP_FR)||(type==GLP_UP))
+        out.lhsMin = -GLPK_INFINITY;
+    if((type==GLP_FR)||(type==GLP_LO))
+        out.lhsMax = GLPK_INFINITY;
+    delGlpkRow(d, id);
+}
+void lpBackend::addRowBackToLP(int id)
+{
+    if(d.glpkRow[id]!=0)
+        return;
+    glpkOutRow& out = d.outRows[id];
+    int row = glp_add_rows(d.lp, 1);
+    glp_set_mat_row(d.lp, row, out.ind.size()-1, out.ind.data(), out.val.data());
+    glp_set_row_bnds(d.lp, row, glpkBndType(out.lhsMin,out.lhsMax), out.lhsMin, out.lhsMax);
+    d.glpkRow[id] = row;
+    d.rowOfGlpk.push_back(id);
+    out.ind.clear();
+    out.val.clear();
+}
+void lpBackend::delRow(int id)
+{
+    if(d.glpkRow[id]!=0)
+        delGlpkRow(d, id);
+    d.outRows[id].ind.clear();
+    d.outRows[id].val.clear();
+}
+double lpBackend::getRowLB(int id)
+{
+    if(d.glpkRow[id]==0)
+        return d.outRows[id].lhsMin;
+    return glp_get_row_lb(d.lp, d.glpkRow[id]);
+}
+double lpBackend::getDual(int id)
+{
+    if(d.glpkRow[id]==0)
+        return 0;
+    return glp_get_row_dual(d.lp, d.glpkRow[id]);
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |               SOLVE                |
+                         +-----------------------------------*/
+int lpBackend::solve()
+{
+    int itStart = glp_get_it_cnt(d.lp);
+    d.nrIters = 0;
+    int ret = glp_simplex(d.lp, &d.smParams);
+    //deleting a row whose auxiliary variable is non-basic invalidates the basis
+    if((ret==GLP_EBADB)||(ret==GLP_ESING)||(ret==GLP_ECOND)||(ret==GLP_EFAIL)){
+        glp_adv_basis(d.lp, 0);
+        ret = glp_simplex(d.lp, &d.smParams);
+    }
+    d.nrIters = glp_get_it_cnt(d.lp)-itStart;
+    if(ret==GLP_ETMLIM)
+        return LP_TIME_LIMIT;
+    if((ret!=0)&&(ret!=GLP_EITLIM))
+        throw lpBackendError("glpk: glp_simplex failed");
+    int status = glp_get_status(d.lp);
+    if(status==GLP_NOFEAS)
+        return LP_INFEASIBLE;
+    if(status==GLP_UNBND)
+        return LP_INFEAS_OR_UNBOUNDED;
+    if(d.nrIntVars==0)
+        return LP_OPTIMAL;
+    ret = glp_intopt(d.lp, &d.ioParams);
+    if(ret==GLP_ETMLIM)
+        return LP_TIME_LIMIT;
+    if(glp_mip_status(d.lp)==GLP_NOFEAS)
+        return LP_INFEASIBLE;
+    return LP_OPTIMAL;
+}
+//The row fixing the objective stays in the LP (free) between calls: deleting it would
+//invalidate the basis whenever its auxiliary variable is non-basic
+int lpBackend::solveWithObjFixed(double* origCoefs, double* tmpCoefs)
+{
+    vector<int>    ind(n+1);
+    vector<double> vals(n+1);
+    for(int i=0;i<n;i++){
+        ind[i+1]  = i+1;
+        vals[i+1] = origCoefs[i];
+    }
+    double optVal = glp_get_obj_val(d.lp);
+    if(d.objRow==0){
+        d.objRow = glp_add_rows(d.lp, 1);
+        d.rowOfGlpk.push_back(-1);
+    }
+    glp_set_mat_row(d.lp, d.objRow, n, ind.data(), vals.data());
+    glp_set_row_bnds(d.lp, d.objRow, GLP_FX, optVal, optVal);
+    for(int i=0;i<n;i++)
+        glp_set_obj_coef(d.lp, i+1, tmpCoefs[i]);
+    //the basis stays primal feasible in both solves below, the primal simplex fits better
+    int meth = d.smParams.meth;
+    d.smParams.meth = GLP_PRIMAL;
+    int itStart = glp_get_it_cnt(d.lp);
+    glp_simplex(d.lp, &d.smParams);
+    glp_set_row_bnds(d.lp, d.objRow, GLP_FR, 0, 0);
+    for(int i=0;i<n;i++)
+        glp_set_obj_coef(d.lp, i+1, origCoefs[i]);
+    int status = solve();
+    d.smParams.meth = meth;
+    d.nrIters = glp_get_it_cnt(d.lp)-itStart;
+    return status;
+}
+double lpBackend::getObjVal()
+{
+    if(d.nrIntVars>0)
+        return glp_mip_obj_val(d.lp);
+    return glp_get_obj_val(d.lp);
+}
+void lpBackend::getPrimals(double* x)
+{
+    for(int i=0;i<n;i++)
+        x[i] = (d.nrIntVars>0) ? glp_mip_col_val(d.lp, i+1) : glp_get_col_prim(d.lp, i+1);
+}
+void lpBackend::setStart(double*)
+{
+    //glpk has no primal starting point for the simplex, it keeps the last basis anyway
+}
+void lpBackend::exportModel(const char* filename)
+{
+    glp_write_lp(d.lp, NULL, filename);
+}
+long lpBackend::getNrIters()
+{
+    return d.nrIters;
+}
+
+/*-----------------------+------------------------------------+--------------------------
+                         |     WARM START AND BASIS REUSE     |
+                         +-----------------------------------*/
+//glpk always starts from the current basis (presolve is off), only the method changes
+void lpBackend::setWarmStart(int on)
+{
+    d.warmStart = on;
+    d.smParams.meth = on ? GLP_DUALP : GLP_PRIMAL;
+}
+void lpBackend::saveBasis()
+{
+    d.savedColStat.resize(n);
+    for(int j=0;j<n;j++)
+        d.savedColStat[j] = glp_get_col_stat(d.lp, j+1);
+    d.savedRowStat.assign(d.glpkRow.size(), 0);
+    for(int id=0;id<(int)d.glpkRow.size();id++)
+        if(d.glpkRow[id]!=0)
+            d.savedRowStat[id] = glp_get_row_stat(d.lp, d.glpkRow[id]);
+    if(d.objRow!=0)
+        d.savedObjRowStat = glp_get_row_stat(d.lp, d.objRow);
+    d.basisSaved = 1;
+}
+//glp_set_col_stat/glp_set_row_stat adapt a non-basic status to the current bound type
+void lpBackend::restoreBasis()
+{
+    if((!d.basisSaved)||((int)d.savedColStat.size()!=n))
+        return;                                //no basis or columns added/removed since
+    for(int j=0;j<n;j++)
+        glp_set_col_stat(d.lp, j+1, d.savedColStat[j]);
+    for(int id=0;id<(int)d.glpkRow.size();id++){
+        if(d.glpkRow[id]==0)
+            continue;
+        int stat = GLP_BS;                     //a new row enters with its slack basic
+        if((id<(int)d.savedRowStat.size())&&(d.savedRowStat[id]!=0))
+            stat = d.savedRowStat[id];
+        glp_set_row_stat(d.lp, d.glpkRow[id], stat);
+    }
+    if(d.objRow!=0)
+        glp_set_row_stat(d.lp, d.objRow, d.savedObjRowStat);
+}
+int lpBackend::rowSlackBasic(int id)
+{
+    if((!d.basisSaved)||(id>=(int)d.savedRowStat.size())||(d.savedRowStat[id]==0))
+        return 1;
+    return (d.savedRowStat[id]==GLP_BS);
+}